@@ -0,0 +1,6 @@
+// std140, mirrored by Shader::CameraBlock. Uploaded once per frame by Renderer::setCamera.
+layout(std140) uniform Camera {
+    mat4 u_view;
+    mat4 u_projection;
+    vec3 u_viewPos;
+};
@@ -0,0 +1,20 @@
+uniform vec3 u_positionOffset;
+uniform vec3 u_positionScale;
+uniform vec2 u_uvOffset;
+uniform vec2 u_uvScale;
+
+vec3 dequantizePosition(vec3 position) {
+    return u_positionOffset + position * u_positionScale;
+}
+
+vec2 dequantizeUv(vec2 uv) {
+    return u_uvOffset + uv * u_uvScale;
+}
+
+vec3 octDecode(vec2 encoded) {
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -t : t;
+    normal.y += normal.y >= 0.0 ? -t : t;
+    return normalize(normal);
+}
@@ -25,4 +25,10 @@ struct SpotLight {
     float constant;
     float linear;
     float quadratic;
+};
+
+// std140, mirrored by Shader::LightBlock. Uploaded once per frame by Renderer::setLights.
+layout(std140) uniform Lights {
+    DirectionalLight u_directionalLight;
+    PointLight u_pointLight;
 };
\ No newline at end of file
@@ -8,6 +8,7 @@ struct Material {
     float shine;
 };
 
+#ifdef MATERIAL_MAP
 struct MaterialMap {
     vec3 ambient;
     sampler2D diffuse;
@@ -18,6 +19,7 @@ struct MaterialMap {
 
 Material sampleMap(MaterialMap material, vec2 texCoords) {
     Material sampled;
+    sampled.ambient = material.ambient;
     sampled.diffuse = texture(material.diffuse, texCoords).rgb;
     sampled.specular = texture(material.specular, texCoords).rgb;
     sampled.emission = texture(material.emission, texCoords).rgb;
@@ -25,6 +27,20 @@ Material sampleMap(MaterialMap material, vec2 texCoords) {
     return sampled;
 }
 
+#ifdef TEXTURE_ARRAY
+// Diffuse, specular and emission in the three layers after the color one
+Material sampleLayers(sampler2DArray maps, vec2 texCoords, float colorLayer, vec3 ambient, float shine) {
+    Material sampled;
+    sampled.ambient = ambient;
+    sampled.diffuse = texture(maps, vec3(texCoords, colorLayer + 1.0)).rgb;
+    sampled.specular = texture(maps, vec3(texCoords, colorLayer + 2.0)).rgb;
+    sampled.emission = texture(maps, vec3(texCoords, colorLayer + 3.0)).rgb;
+    sampled.shine = shine;
+    return sampled;
+}
+#endif
+#endif
+
 vec3 calcAmbient(vec3 materialAmbient, vec3 lightAmbient) {
     return materialAmbient * lightAmbient;
 }
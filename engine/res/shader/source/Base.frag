@@ -1,4 +1,5 @@
 #version 330 core
+#include ENGINE_RES_PATH/shader/include/Camera.glsl
 #include ENGINE_RES_PATH/shader/include/Material.glsl
 
 in vec2 v_texCoord;
@@ -6,9 +7,7 @@ in vec3 v_normal;
 in vec3 v_fragPos;
 
 uniform sampler2D u_texture1;
-uniform vec3 u_viewPos;
 uniform Material u_material;
-uniform DirectionalLight u_light;
 
 out vec4 fragColor;
 
@@ -17,6 +16,6 @@ void main() {
     vec3 normal = normalize(v_normal);
     vec3 viewDir = normalize(u_viewPos - v_fragPos);
     // vec4 normalColor = vec4(normalize(v_normal) * 0.5 + 0.5, 1.0);
-    vec4 result = texColor * vec4(phongLighting(u_material, u_light, normal, viewDir, v_fragPos), 1.0);
+    vec4 result = texColor * vec4(phongLighting(u_material, u_directionalLight, normal, viewDir, v_fragPos), 1.0);
     fragColor = result;
 }
@@ -5,38 +5,100 @@
 layout (location = 0) in vec3 a_pos;
 layout (location = 1) in vec2 a_uv;
 layout (location = 2) in vec3 a_normal;
+#ifdef VERTEX_COLOR
+layout (location = 3) in vec3 a_color;
+#endif
+#ifdef INSTANCED
+layout (location = 4) in mat4 i_model;
+#endif
+#ifdef TEXTURE_ARRAY
+layout (location = 8) in vec4 i_region;
+layout (location = 9) in float i_layer;
+#endif
 
+#ifdef VERTEX_COLOR
+out vec3 v_vertexColor;
+#endif
 out vec2 v_texCoord;
 out vec3 v_normal;
 out vec3 v_fragPos;
+#ifdef TEXTURE_ARRAY
+flat out float v_layer;
+#endif
 
 void main() {
-    gl_Position = getMvp() * vec4(a_pos, 1.0);
+#ifdef INSTANCED
+    mat4 model = i_model * u_model;
+#else
+    mat4 model = u_model;
+#endif
+    gl_Position = u_projection * u_view * model * vec4(a_pos, 1.0);
+#ifdef VERTEX_COLOR
+    v_vertexColor = a_color;
+#endif
+#ifdef TEXTURE_ARRAY
+    v_texCoord = a_uv * i_region.zw + i_region.xy;
+    v_layer = i_layer;
+#else
     v_texCoord = a_uv;
-    v_normal = a_normal;
-    v_fragPos = vec3(u_model * vec4(a_pos, 1.0));
+#endif
+    v_normal = a_normal;// mat3(transpose(inverse(model))) * aNormal; For model matrices with non uniform scale
+    v_fragPos = vec3(model * vec4(a_pos, 1.0));
 }
 
 #shader fragment
 #version 330 core
+#include ENGINE_RES_PATH/shader/include/Camera.glsl
 #include ENGINE_RES_PATH/shader/include/Material.glsl
 
+#ifdef VERTEX_COLOR
+in vec3 v_vertexColor;
+#endif
 in vec2 v_texCoord;
 in vec3 v_normal;
 in vec3 v_fragPos;
+#ifdef TEXTURE_ARRAY
+flat in float v_layer;
+#endif
 
 out vec4 fragColor;
 
+#ifdef TEXTURE_ARRAY
+uniform sampler2DArray u_textures;
+#else
 uniform sampler2D u_texture1;
-uniform vec3 u_viewPos;
+#endif
+#ifdef MATERIAL_MAP
+uniform MaterialMap u_matMap;
+#else
 uniform Material u_material;
-uniform DirectionalLight u_light;
+#endif
 
 void main() {
+#ifdef TEXTURE_ARRAY
+    vec4 texColor = texture(u_textures, vec3(v_texCoord, v_layer));
+#else
     vec4 texColor = texture(u_texture1, v_texCoord);
+#endif
 
     vec3 normal = normalize(v_normal);
     vec3 viewDir = normalize(u_viewPos - v_fragPos);
-    vec4 result = texColor * vec4(phongLighting(u_material, u_light, normal, viewDir, v_fragPos), 1.0);
-    fragColor = result;
+#ifdef MATERIAL_MAP
+#ifdef TEXTURE_ARRAY
+    Material material = sampleLayers(u_textures, v_texCoord, v_layer, u_matMap.ambient, u_matMap.shine);
+#else
+    Material material = sampleMap(u_matMap, v_texCoord);
+#endif
+#else
+    Material material = u_material;
+#endif
+#ifdef POINT_LIGHT
+    vec3 light = phongLighting(material, u_pointLight, normal, viewDir, v_fragPos);
+#else
+    vec3 light = phongLighting(material, u_directionalLight, normal, viewDir, v_fragPos);
+#endif
+#ifdef VERTEX_COLOR
+    light *= v_vertexColor;
+#endif
+    fragColor = texColor * vec4(light, 1.0);
 }
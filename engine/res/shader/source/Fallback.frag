@@ -0,0 +1,11 @@
+#version 330 core
+
+// Drawn while the real program is still compiling, needs nothing but the normal
+
+in vec3 v_normal;
+
+out vec4 fragColor;
+
+void main() {
+    fragColor = vec4(normalize(v_normal) * 0.5 + 0.5, 1.0);
+}
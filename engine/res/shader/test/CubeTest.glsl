@@ -1,5 +1,6 @@
 #shader vertex
 #version 330 core
+#include ENGINE_RES_PATH/shader/include/Camera.glsl
 
 layout (location = 0) in vec3 a_pos;
 layout (location = 1) in vec3 a_color;
@@ -7,12 +8,10 @@ layout (location = 1) in vec3 a_color;
 out vec3 vertexColor;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(a_pos, 1.0);
+    gl_Position = u_projection * u_view * model * vec4(a_pos, 1.0);
     vertexColor = a_color;
 }
 
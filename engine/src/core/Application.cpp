@@ -10,6 +10,8 @@
 #include "InputMap.h"
 
 #include "renderer/GlRenderer.h"
+#include "renderer/ResourceCache.h"
+#include "renderer/shader/ProgramCache.h"
 #include "scene/test/Test.h"
 #include "scene/test/Cube.h"
 
@@ -169,5 +171,22 @@ void Engine::Application::run() {
 }
 
 void Engine::Application::setBaseScene(std::unique_ptr<Scene::Scene> baseScene) {
+    // Built while the last scene still held its resources, whatever they share was a cache hit
     m_baseScene = std::move(baseScene);
+
+    using Renderer::ResourceCache;
+    auto& resourceCache = ResourceCache::current();
+    resourceCache.collect();
+    for (size_t type{}; type < static_cast<size_t>(ResourceCache::Type::COUNT); type++) {
+        const auto& stats = resourceCache.getStats(static_cast<ResourceCache::Type>(type));
+        LOG(ResourceCache::toString(static_cast<ResourceCache::Type>(type)) << ": " << stats.resident << " resident ("
+            << stats.bytes / 1024 << " KiB), " << stats.hits << " hits, " << stats.misses << " misses\n");
+    }
+
+    // The base scene has built its programs by now
+    if (Renderer::Renderer::getActiveRenderer()->getCapabilities().programBinary) {
+        const auto& stats = Renderer::Shader::ProgramCache::getStats();
+        LOG("Program cache: " << stats.hits << " hits, " << stats.misses << " misses, " << stats.rejected
+            << " rejected\n");
+    }
 }
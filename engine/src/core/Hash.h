@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace Engine::Hash {
+    inline constexpr uint64_t s_fnvOffset64{0xcbf29ce484222325ull};
+    inline constexpr uint64_t s_fnvPrime64{0x100000001b3ull};
+
+    constexpr uint64_t fnv1a64(const std::string_view data, uint64_t hash = s_fnvOffset64) {
+        for (const char c: data) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= s_fnvPrime64;
+        }
+
+        return hash;
+    }
+
+    constexpr uint64_t mix64(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // Word at a time hash for large blobs (file contents), where byte-wise FNV is too slow
+    inline uint64_t bytes(const void* data, const size_t size, uint64_t seed = s_fnvOffset64) {
+        const auto* it = static_cast<const uint8_t*>(data);
+        uint64_t hash = seed ^ (size * 0x9e3779b97f4a7c15ull);
+
+        size_t remaining = size;
+        for (; remaining >= sizeof(uint64_t); remaining -= sizeof(uint64_t), it += sizeof(uint64_t)) {
+            uint64_t word{};
+            std::memcpy(&word, it, sizeof(word));
+            hash = (hash ^ mix64(word)) * 0x9e3779b97f4a7c15ull;
+            hash ^= hash >> 29;
+        }
+
+        uint64_t tail{};
+        std::memcpy(&tail, it, remaining);
+        return mix64(hash ^ mix64(tail));
+    }
+}
@@ -0,0 +1,113 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "Log.h"
+
+#ifdef _WIN32
+
+Engine::MappedFile::MappedFile(const std::string& path) {
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOG_ERR("Could not open file for mapping: " << path << '\n');
+        return;
+    }
+
+    LARGE_INTEGER fileSize{};
+    if (GetFileSizeEx(file, &fileSize) == 0) {
+        LOG_ERR("Could not stat file for mapping: " << path << '\n');
+        CloseHandle(file);
+        return;
+    }
+
+    m_fileHandle = file;
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    m_open = true;
+
+    if (m_size == 0) {
+        return;
+    }
+
+    m_mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mappingHandle == nullptr) {
+        LOG_ERR("Could not create file mapping: " << path << '\n');
+        close();
+        return;
+    }
+
+    m_data = static_cast<const char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+        LOG_ERR("Could not map view of file: " << path << '\n');
+        close();
+    }
+}
+
+void Engine::MappedFile::close() {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+
+    if (m_mappingHandle != nullptr) {
+        CloseHandle(m_mappingHandle);
+    }
+
+    if (m_fileHandle != nullptr) {
+        CloseHandle(m_fileHandle);
+    }
+
+    release();
+}
+
+#else
+
+Engine::MappedFile::MappedFile(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERR("Could not open file for mapping: " << path << '\n');
+        return;
+    }
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0) {
+        LOG_ERR("Could not stat file for mapping: " << path << '\n');
+        ::close(fd);
+        return;
+    }
+
+    m_size = static_cast<size_t>(fileStat.st_size);
+    m_open = true;
+
+    if (m_size > 0) {
+        void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            LOG_ERR("Could not map file: " << path << '\n');
+            release();
+        } else {
+            madvise(mapping, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char*>(mapping);
+        }
+    }
+
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+}
+
+void Engine::MappedFile::close() {
+    if (m_data != nullptr) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+
+    release();
+}
+
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Engine {
+    // Read-only memory mapping of a whole file. The mapping lives as long as the object does.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+
+        explicit MappedFile(const std::string& path);
+
+        MappedFile(const MappedFile&) = delete;
+
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept : m_data{other.m_data}, m_size{other.m_size}, m_open{other.m_open}
+#ifdef _WIN32
+                                                  , m_fileHandle{other.m_fileHandle},
+                                                  m_mappingHandle{other.m_mappingHandle}
+#endif
+        {
+            other.release();
+        }
+
+        MappedFile& operator=(MappedFile&& other) noexcept {
+            if (&other == this) {
+                return *this;
+            }
+
+            close();
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_open = other.m_open;
+#ifdef _WIN32
+            m_fileHandle = other.m_fileHandle;
+            m_mappingHandle = other.m_mappingHandle;
+#endif
+            other.release();
+            return *this;
+        }
+
+        ~MappedFile() {
+            close();
+        }
+
+        void close();
+
+        [[nodiscard]] bool isOpen() const {
+            return m_open;
+        }
+
+        [[nodiscard]] const char* data() const {
+            return m_data;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return m_size;
+        }
+
+        [[nodiscard]] std::string_view view() const {
+            return std::string_view{m_data, m_size};
+        }
+
+    private:
+        void release() {
+            m_data = {};
+            m_size = {};
+            m_open = {};
+#ifdef _WIN32
+            m_fileHandle = {};
+            m_mappingHandle = {};
+#endif
+        }
+
+        const char* m_data{};
+        size_t m_size{};
+        bool m_open{}; // Empty files are open but have no mapping
+#ifdef _WIN32
+        void* m_fileHandle{};
+        void* m_mappingHandle{};
+#endif
+    };
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace Engine {
+    // Lock-free queue for many producers and a single consumer. A push is one compare and swap, the consumer takes
+    // everything queued so far in one exchange and gets it back oldest first.
+    template<typename T>
+    class MpscQueue {
+    public:
+        MpscQueue() = default;
+
+        MpscQueue(const MpscQueue&) = delete;
+
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        MpscQueue(MpscQueue&&) = delete;
+
+        MpscQueue& operator=(MpscQueue&&) = delete;
+
+        ~MpscQueue() {
+            popAll([](T&&) {
+            });
+        }
+
+        void push(T value) {
+            auto* node = new Node{std::move(value), m_head.load(std::memory_order_relaxed)};
+            while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+            }
+        }
+
+        // Consumer thread only
+        template<typename Func>
+        void popAll(Func&& func) {
+            Node* node = m_head.exchange(nullptr, std::memory_order_acquire);
+
+            // Pushed newest first, reversed to hand them out in order
+            Node* oldest{};
+            while (node != nullptr) {
+                Node* next = node->next;
+                node->next = oldest;
+                oldest = node;
+                node = next;
+            }
+
+            while (oldest != nullptr) {
+                Node* next = oldest->next;
+                func(std::move(oldest->value));
+                delete oldest;
+                oldest = next;
+            }
+        }
+
+    private:
+        struct Node {
+            T value;
+            Node* next;
+        };
+
+        std::atomic<Node*> m_head{};
+    };
+}
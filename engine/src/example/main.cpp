@@ -1,13 +1,223 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
 #include "core/Application.h"
+#include "renderer/TextureCache.h"
+#include "renderer/model/MeshCache.h"
+#include "renderer/model/ObjParser.h"
+#include "renderer/shader/Parser.h"
 #include "scene/test/Test.h"
 #include "scene/test/Cube2.h"
+#include "scene/test/FillRate.h"
 #include "scene/test/ModelTest.h"
 
-int main([[maybe_unused]] int /*unused*/, [[maybe_unused]] char** /*unused*/) {
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::chrono::duration<double>;
+
+    // Optional count after the mode, like --bench-shaders 1000
+    size_t parseCount(const int argc, char** argv, const size_t fallback) {
+        if (argc < 3) {
+            return fallback;
+        }
+
+        const std::string_view argument{argv[2]};
+        size_t count{};
+        const auto [end, error] = std::from_chars(argument.data(), argument.data() + argument.size(), count);
+        return error == std::errc{} && end == argument.data() + argument.size() && count > 0 ? count : fallback;
+    }
+
+    // Every shader file under the resources, each preprocessed runs times in a row with a warm file cache
+    int benchShaders(const size_t runs) {
+        std::vector<std::string> paths;
+        for (const auto& entry: std::filesystem::recursive_directory_iterator{ENGINE_RES_PATH}) {
+            const auto extension = entry.path().extension();
+            if (entry.is_regular_file() && (extension == ".glsl" || extension == ".vert" || extension == ".frag")) {
+                paths.push_back(entry.path().generic_string());
+            }
+        }
+        std::ranges::sort(paths);
+
+        // The parser logs every stage it outputs, which would be most of what gets timed
+        auto* const output = std::cout.rdbuf(nullptr);
+        std::vector<double> seconds(paths.size());
+        for (size_t i{}; i < paths.size(); i++) {
+            const auto start = Clock::now();
+            for (size_t run{}; run < runs; run++) {
+                Engine::Renderer::Shader::Parser parser{paths[i]};
+                while (parser.next()) {
+                }
+            }
+            seconds[i] = Duration{Clock::now() - start}.count();
+        }
+        std::cout.rdbuf(output);
+
+        double total{};
+        for (size_t i{}; i < paths.size(); i++) {
+            LOG(paths[i] << ": " << seconds[i] / static_cast<double>(runs) * 1e6 << " us per parse\n");
+            total += seconds[i];
+        }
+        LOG(paths.size() << " files, " << runs << " runs each, " << total << " s\n");
+        return 0;
+    }
+
+    // Flat square grid of faceCount triangles, every vertex with its own uv and all sharing one normal. Written to
+    // the cache once and reused by later runs.
+    std::string writeGrid(const size_t faceCount) {
+        const auto path = std::string{ENGINE_CACHE_PATH"/Grid-"} + std::to_string(faceCount) + ".obj";
+        if (std::filesystem::exists(path)) {
+            return path;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(ENGINE_CACHE_PATH, error);
+        const auto side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(faceCount) / 2.0)));
+        const auto tempPath = path + ".tmp";
+        {
+            std::ofstream file{tempPath, std::ios::trunc};
+            for (size_t y{}; y <= side; y++) {
+                for (size_t x{}; x <= side; x++) {
+                    file << "v " << x << " 0 " << y << '\n';
+                }
+            }
+            for (size_t y{}; y <= side; y++) {
+                for (size_t x{}; x <= side; x++) {
+                    file << "vt " << static_cast<double>(x) / static_cast<double>(side) << ' ' <<
+                        static_cast<double>(y) / static_cast<double>(side) << '\n';
+                }
+            }
+            file << "vn 0 1 0\n";
+
+            const auto corner = [&file](const size_t index) {
+                file << ' ' << index << '/' << index << "/1";
+            };
+            for (size_t face{}; face < faceCount; face++) {
+                const size_t quad = face / 2;
+                const size_t a = quad / side * (side + 1) + quad % side + 1;
+                const size_t c = a + side + 1;
+                file << 'f';
+                corner(face % 2 == 0 ? a : a + 1);
+                corner(c);
+                corner(face % 2 == 0 ? a + 1 : c + 1);
+                file << '\n';
+            }
+        }
+
+        std::filesystem::rename(tempPath, path, error);
+        return path;
+    }
+
+    // Each mode parses the same file a few times, the best run counts
+    int benchObjModes(const size_t faceCount) {
+        using Mode = Engine::Renderer::ObjParser::Mode;
+        constexpr int runs{3};
+
+        const auto path = writeGrid(faceCount);
+        const auto fileSize = static_cast<double>(std::filesystem::file_size(path));
+        LOG(path << ": " << fileSize / (1024 * 1024) << " MiB\n");
+
+        double streamSeconds{};
+        for (const auto& [mode, name]: {
+                 std::pair{Mode::STREAM, "stream"}, std::pair{Mode::MAPPED, "mapped"},
+                 std::pair{Mode::PARALLEL, "parallel"}
+             }) {
+            double best{};
+            size_t faces{};
+            for (int run{}; run < runs; run++) {
+                const auto start = Clock::now();
+                Engine::Renderer::ObjParser parser{path, mode};
+                const auto meshData = parser.next();
+                const double seconds = Duration{Clock::now() - start}.count();
+                best = run == 0 ? seconds : std::min(best, seconds);
+                faces = meshData.indices.size() / 3;
+            }
+
+            if (mode == Mode::STREAM) {
+                streamSeconds = best;
+            }
+            LOG(name << ": " << best * 1e3 << " ms, " << fileSize / best / (1024 * 1024) << " MiB/s, " << faces <<
+                " faces, " << streamSeconds / best << "x stream\n");
+        }
+
+        return 0;
+    }
+
+    // Vertex dedup table behaviour and parse throughput on the bundled models and a generated grid
+    int benchDedup(const size_t faceCount) {
+        std::vector<std::string> paths;
+        for (const auto& entry: std::filesystem::directory_iterator{ENGINE_RES_PATH"/model"}) {
+            if (entry.path().extension() == ".obj") {
+                paths.push_back(entry.path().generic_string());
+            }
+        }
+        std::ranges::sort(paths);
+        paths.push_back(writeGrid(faceCount));
+
+        for (const auto& path: paths) {
+            const auto start = Clock::now();
+            Engine::Renderer::ObjParser parser{path};
+            const auto meshData = parser.next();
+            const double seconds = Duration{Clock::now() - start}.count();
+
+            const auto faces = static_cast<double>(meshData.indices.size() / 3);
+            const auto& stats = parser.getDedupStats();
+            LOG(path << ": " << seconds * 1e3 << " ms, " << faces / seconds / 1e6 << " M faces/s, " << stats.size <<
+                " vertices in " << stats.capacity << " slots, load factor " << stats.getLoadFactor() <<
+                ", average probe " << stats.getAverageProbeLength() << ", max probe " << stats.maxProbeLength << ", " <<
+                stats.rehashes << " rehashes\n");
+        }
+
+        return 0;
+    }
+}
+
+int main(const int argc, char** argv) {
 #ifdef __linux__
     setenv("ASAN_OPTIONS", "detect_leaks=1", 1);
 #endif
+    // Offline cook step: first-person-sus --cook a.obj b.png ...
+    if (argc > 1 && std::string_view{argv[1]} == "--cook") {
+        bool cooked{true};
+        for (int i{2}; i < argc; i++) {
+            if (std::string_view{argv[i]}.ends_with(".obj")) {
+                cooked &= Engine::Renderer::MeshCache::cook(argv[i], Engine::Renderer::MeshCache::cookedPath(argv[i]));
+            } else {
+                cooked &= Engine::Renderer::TextureCache::cook(argv[i],
+                                                               Engine::Renderer::TextureCache::cookedPath(argv[i]));
+            }
+        }
+
+        return cooked ? 0 : 1;
+    }
+
+    // Shader preprocessor benchmark: first-person-sus --bench-shaders [runs]
+    if (argc > 1 && std::string_view{argv[1]} == "--bench-shaders") {
+        return benchShaders(parseCount(argc, argv, 10'000));
+    }
+
+    // Obj parse modes on a generated grid: first-person-sus --bench-obj [faces]
+    if (argc > 1 && std::string_view{argv[1]} == "--bench-obj") {
+        return benchObjModes(parseCount(argc, argv, 4'000'000));
+    }
+
+    // Vertex dedup table statistics: first-person-sus --bench-dedup [grid faces]
+    if (argc > 1 && std::string_view{argv[1]} == "--bench-dedup") {
+        return benchDedup(parseCount(argc, argv, 10'000'000));
+    }
+
     Engine::Application& application = Engine::Application::initialize("Hej", 960, 540);
-    application.setBaseScene(std::move(std::make_unique<Engine::ModelTest>()));
+    // Texture filtering microbenchmark: first-person-sus --fill-rate
+    if (argc > 1 && std::string_view{argv[1]} == "--fill-rate") {
+        application.setBaseScene(std::move(std::make_unique<Engine::Scene::FillRate>()));
+    } else {
+        application.setBaseScene(std::move(std::make_unique<Engine::ModelTest>()));
+    }
     application.run();
 }
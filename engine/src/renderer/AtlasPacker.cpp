@@ -0,0 +1,94 @@
+#include "AtlasPacker.h"
+
+#include <algorithm>
+
+#include "core/Assert.h"
+
+Engine::Renderer::AtlasPacker::AtlasPacker(const glm::ivec2 size) : m_size{size}, m_skyline{Segment{0, 0, size.x}} {
+    ASSERT(size.x > 0 && size.y > 0);
+}
+
+std::optional<glm::ivec2> Engine::Renderer::AtlasPacker::insert(const glm::ivec2 size) {
+    if (size.x <= 0 || size.y <= 0) {
+        return std::nullopt;
+    }
+
+    // Lowest top edge wins, the narrower segment breaks ties so wide gaps stay open for wide rectangles
+    std::optional<size_t> best;
+    int bestTop{};
+    int bestWidth{};
+    for (size_t i{}; i < m_skyline.size(); i++) {
+        const auto y = fit(i, size);
+        if (!y) {
+            continue;
+        }
+
+        const int top = *y + size.y;
+        if (!best || top < bestTop || (top == bestTop && m_skyline[i].width < bestWidth)) {
+            best = i;
+            bestTop = top;
+            bestWidth = m_skyline[i].width;
+        }
+    }
+
+    if (!best) {
+        return std::nullopt;
+    }
+
+    const glm::ivec2 position{m_skyline[*best].x, bestTop - size.y};
+    place(*best, position, size);
+    m_usedArea += static_cast<uint64_t>(size.x) * static_cast<uint64_t>(size.y);
+    return position;
+}
+
+float Engine::Renderer::AtlasPacker::getOccupancy() const {
+    return static_cast<float>(static_cast<double>(m_usedArea) / (static_cast<double>(m_size.x) * m_size.y));
+}
+
+std::optional<int> Engine::Renderer::AtlasPacker::fit(const size_t segment, const glm::ivec2 size) const {
+    if (m_skyline[segment].x + size.x > m_size.x) {
+        return std::nullopt;
+    }
+
+    int y{};
+    int widthLeft = size.x;
+    for (size_t i = segment; widthLeft > 0; i++) {
+        y = std::max(y, m_skyline[i].y);
+        if (y + size.y > m_size.y) {
+            return std::nullopt;
+        }
+
+        widthLeft -= m_skyline[i].width;
+    }
+
+    return y;
+}
+
+void Engine::Renderer::AtlasPacker::place(const size_t segment, const glm::ivec2 position, const glm::ivec2 size) {
+    const auto inserted = m_skyline.insert(m_skyline.begin() + static_cast<ptrdiff_t>(segment),
+                                           Segment{position.x, position.y + size.y, size.x});
+
+    // Cut the segments the new one now covers
+    const int right = position.x + size.x;
+    auto it = inserted + 1;
+    while (it != m_skyline.end() && it->x < right) {
+        const int overlap = right - it->x;
+        if (overlap < it->width) {
+            it->x += overlap;
+            it->width -= overlap;
+            break;
+        }
+
+        it = m_skyline.erase(it);
+    }
+
+    // Neighbours at the same height become one segment
+    for (size_t i{}; i + 1 < m_skyline.size();) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + static_cast<ptrdiff_t>(i) + 1);
+        } else {
+            i++;
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <glm/vec2.hpp>
+
+namespace Engine::Renderer {
+    // Skyline bottom-left rectangle packer (Jylänki 2010). Only remembers the top edge of what was placed so far,
+    // which keeps inserts cheap and wastes little when rectangles go in sorted by height.
+    class AtlasPacker {
+    public:
+        explicit AtlasPacker(glm::ivec2 size);
+
+        // Where the rectangle went, none if it does not fit anymore
+        std::optional<glm::ivec2> insert(glm::ivec2 size);
+
+        [[nodiscard]] glm::ivec2 getSize() const {
+            return m_size;
+        }
+
+        // Placed area over the whole area
+        [[nodiscard]] float getOccupancy() const;
+
+    private:
+        struct Segment {
+            int x{};
+            int y{}; // Everything below is taken
+            int width{};
+        };
+
+        // Lowest y a rectangle starting at the segment can sit at, none if it sticks out
+        [[nodiscard]] std::optional<int> fit(size_t segment, glm::ivec2 size) const;
+
+        void place(size_t segment, glm::ivec2 position, glm::ivec2 size);
+
+        glm::ivec2 m_size;
+        std::vector<Segment> m_skyline;
+        uint64_t m_usedArea{};
+    };
+}
@@ -0,0 +1,438 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <glm/geometric.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/vec3.hpp>
+
+#include "core/Assert.h"
+
+namespace {
+    using Engine::Renderer::BlockCompression::Format;
+    using Engine::Renderer::BlockCompression::s_blockSize;
+
+    constexpr size_t s_texelCount{s_blockSize * s_blockSize};
+    constexpr int s_greyTolerance{2};
+    constexpr int s_powerIterations{8};
+
+    using Texel = std::array<uint8_t, 4>;
+    using Block = std::array<Texel, s_texelCount>; // Row by row
+    using ColorPalette = std::array<Texel, 4>;
+    using ChannelPalette = std::array<uint8_t, 8>;
+
+    struct ColorFit {
+        uint16_t color0{};
+        uint16_t color1{};
+        uint32_t indices{};
+        uint32_t error{};
+    };
+
+    glm::ivec2 blockCount(const glm::ivec2 size) {
+        constexpr int blockSize{static_cast<int>(s_blockSize)};
+        return (size + glm::ivec2{blockSize - 1}) / blockSize;
+    }
+
+    size_t texelOffset(const glm::ivec2 size, const int x, const int y) {
+        return (static_cast<size_t>(y) * static_cast<size_t>(size.x) + static_cast<size_t>(x)) * 4;
+    }
+
+    // Blocks hanging over the edge repeat the last row and column
+    Block fetchBlock(const std::span<const uint8_t> rgba, const glm::ivec2 size, const glm::ivec2 block) {
+        Block texels{};
+        for (int y{}; y < static_cast<int>(s_blockSize); y++) {
+            for (int x{}; x < static_cast<int>(s_blockSize); x++) {
+                const int sourceX = std::min(block.x * static_cast<int>(s_blockSize) + x, size.x - 1);
+                const int sourceY = std::min(block.y * static_cast<int>(s_blockSize) + y, size.y - 1);
+                std::memcpy(texels[static_cast<size_t>(y) * s_blockSize + static_cast<size_t>(x)].data(),
+                            rgba.data() + texelOffset(size, sourceX, sourceY), 4);
+            }
+        }
+
+        return texels;
+    }
+
+    void storeBlock(const Block& texels, const std::span<uint8_t> rgba, const glm::ivec2 size,
+                    const glm::ivec2 block) {
+        for (int y{}; y < static_cast<int>(s_blockSize); y++) {
+            for (int x{}; x < static_cast<int>(s_blockSize); x++) {
+                const int targetX = block.x * static_cast<int>(s_blockSize) + x;
+                const int targetY = block.y * static_cast<int>(s_blockSize) + y;
+                if (targetX < size.x && targetY < size.y) {
+                    std::memcpy(rgba.data() + texelOffset(size, targetX, targetY),
+                                texels[static_cast<size_t>(y) * s_blockSize + static_cast<size_t>(x)].data(), 4);
+                }
+            }
+        }
+    }
+
+    uint16_t read16(const uint8_t* bytes) {
+        return static_cast<uint16_t>(bytes[0] | bytes[1] << 8);
+    }
+
+    void write16(uint8_t* bytes, const uint16_t value) {
+        bytes[0] = static_cast<uint8_t>(value);
+        bytes[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    uint16_t to565(const glm::vec3 color) {
+        const auto quantize = [](const float value, const float max) {
+            return static_cast<uint16_t>(std::lround(std::clamp(value, 0.f, 255.f) * max / 255.f));
+        };
+
+        return static_cast<uint16_t>(quantize(color.r, 31.f) << 11 | quantize(color.g, 63.f) << 5 |
+                                     quantize(color.b, 31.f));
+    }
+
+    Texel from565(const uint16_t color) {
+        const auto red = static_cast<uint8_t>(color >> 11 & 0x1F);
+        const auto green = static_cast<uint8_t>(color >> 5 & 0x3F);
+        const auto blue = static_cast<uint8_t>(color & 0x1F);
+        return Texel{
+            static_cast<uint8_t>(red << 3 | red >> 2), static_cast<uint8_t>(green << 2 | green >> 4),
+            static_cast<uint8_t>(blue << 3 | blue >> 2), 255
+        };
+    }
+
+    // BC1 switches to three colors and transparent black when color0 <= color1, BC3 always uses four colors
+    ColorPalette colorPalette(const uint16_t color0, const uint16_t color1, const bool allowTransparent) {
+        ColorPalette palette{from565(color0), from565(color1)};
+        const bool fourColors = color0 > color1 || !allowTransparent;
+        for (size_t channel{}; channel < 3; channel++) {
+            const int first = palette[0][channel];
+            const int second = palette[1][channel];
+            if (fourColors) {
+                palette[2][channel] = static_cast<uint8_t>((2 * first + second) / 3);
+                palette[3][channel] = static_cast<uint8_t>((first + 2 * second) / 3);
+            } else {
+                palette[2][channel] = static_cast<uint8_t>((first + second) / 2);
+                palette[3][channel] = 0;
+            }
+        }
+
+        palette[2][3] = 255;
+        palette[3][3] = fourColors ? 255 : 0;
+        return palette;
+    }
+
+    ChannelPalette channelPalette(const uint8_t value0, const uint8_t value1) {
+        ChannelPalette palette{value0, value1};
+        if (value0 > value1) {
+            for (int i{2}; i < 8; i++) {
+                palette[static_cast<size_t>(i)] = static_cast<uint8_t>(((8 - i) * value0 + (i - 1) * value1) / 7);
+            }
+        } else {
+            for (int i{2}; i < 6; i++) {
+                palette[static_cast<size_t>(i)] = static_cast<uint8_t>(((6 - i) * value0 + (i - 1) * value1) / 5);
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        return palette;
+    }
+
+    uint32_t colorDistance(const Texel& a, const Texel& b) {
+        uint32_t distance{};
+        for (size_t channel{}; channel < 3; channel++) {
+            const int difference = a[channel] - b[channel];
+            distance += static_cast<uint32_t>(difference * difference);
+        }
+
+        return distance;
+    }
+
+    // Picks the closest palette entry for every texel, the endpoints are kept in four color order
+    ColorFit fitIndices(const Block& texels, uint16_t color0, uint16_t color1) {
+        if (color0 < color1) {
+            std::swap(color0, color1);
+        }
+
+        ColorFit fit{color0, color1};
+        const auto palette = colorPalette(color0, color1, false);
+        for (size_t i{}; i < s_texelCount; i++) {
+            uint32_t bestIndex{};
+            uint32_t bestDistance{colorDistance(texels[i], palette[0])};
+
+            // Equal endpoints decode in three color mode, where only the first two entries match the palette
+            for (uint32_t index{1}; index < (color0 == color1 ? 1u : 4u); index++) {
+                if (const uint32_t distance = colorDistance(texels[i], palette[index]); distance < bestDistance) {
+                    bestIndex = index;
+                    bestDistance = distance;
+                }
+            }
+
+            fit.indices |= bestIndex << (2 * i);
+            fit.error += bestDistance;
+        }
+
+        return fit;
+    }
+
+    glm::vec3 toVec3(const Texel& texel) {
+        return glm::vec3{static_cast<float>(texel[0]), static_cast<float>(texel[1]), static_cast<float>(texel[2])};
+    }
+
+    // Endpoints from the extremes along the principal axis of the colors, then refined once by least squares on
+    // the indices that gave
+    void encodeColor(const Block& texels, uint8_t* output) {
+        glm::vec3 mean{};
+        glm::vec3 min{255.f};
+        glm::vec3 max{0.f};
+        for (const auto& texel: texels) {
+            const auto color = toVec3(texel);
+            mean += color;
+            min = glm::min(min, color);
+            max = glm::max(max, color);
+        }
+        mean /= static_cast<float>(s_texelCount);
+
+        glm::mat3 covariance{0.f};
+        for (const auto& texel: texels) {
+            const auto offset = toVec3(texel) - mean;
+            covariance += glm::outerProduct(offset, offset);
+        }
+
+        glm::vec3 axis = max - min;
+        for (int i{}; i < s_powerIterations && glm::dot(axis, axis) > 0.f; i++) {
+            axis = covariance * axis;
+            const float length = glm::length(axis);
+            axis = length > 0.f ? axis / length : glm::vec3{};
+        }
+
+        float lowest{};
+        float highest{};
+        for (const auto& texel: texels) {
+            const float projected = glm::dot(toVec3(texel) - mean, axis);
+            lowest = std::min(lowest, projected);
+            highest = std::max(highest, projected);
+        }
+
+        // Pulled in a little, the extremes are rarely worth an endpoint of their own
+        glm::vec3 high = mean + axis * highest;
+        glm::vec3 low = mean + axis * lowest;
+        const glm::vec3 inset = (high - low) / 16.f;
+        high -= inset;
+        low += inset;
+
+        auto fit = fitIndices(texels, to565(high), to565(low));
+
+        // Weights of color0 for the indices, color1 gets the rest
+        constexpr std::array<float, 4> weights{1.f, 0.f, 2.f / 3.f, 1.f / 3.f};
+        float aa{};
+        float ab{};
+        float bb{};
+        glm::vec3 ax{};
+        glm::vec3 bx{};
+        for (size_t i{}; i < s_texelCount; i++) {
+            const float a = weights[fit.indices >> (2 * i) & 3];
+            const float b = 1.f - a;
+            const auto color = toVec3(texels[i]);
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            ax += a * color;
+            bx += b * color;
+        }
+
+        if (const float determinant = aa * bb - ab * ab; std::abs(determinant) > 1e-6f) {
+            const glm::vec3 color0 = (ax * bb - bx * ab) / determinant;
+            const glm::vec3 color1 = (bx * aa - ax * ab) / determinant;
+            if (const auto refined = fitIndices(texels, to565(color0), to565(color1)); refined.error < fit.error) {
+                fit = refined;
+            }
+        }
+
+        write16(output, fit.color0);
+        write16(output + 2, fit.color1);
+        for (size_t i{}; i < 4; i++) {
+            output[4 + i] = static_cast<uint8_t>(fit.indices >> (8 * i));
+        }
+    }
+
+    void decodeColor(const uint8_t* input, Block& texels, const bool allowTransparent) {
+        const auto palette = colorPalette(read16(input), read16(input + 2), allowTransparent);
+        uint32_t indices{};
+        std::memcpy(&indices, input + 4, sizeof(indices));
+        for (size_t i{}; i < s_texelCount; i++) {
+            const auto& color = palette[indices >> (2 * i) & 3];
+            std::copy_n(color.begin(), allowTransparent ? 4 : 3, texels[i].begin());
+        }
+    }
+
+    // Eight interpolated values between the extremes, equal extremes leave every index at 0
+    void encodeChannel(const Block& texels, const size_t channel, uint8_t* output) {
+        uint8_t min{255};
+        uint8_t max{0};
+        for (const auto& texel: texels) {
+            min = std::min(min, texel[channel]);
+            max = std::max(max, texel[channel]);
+        }
+
+        const auto palette = channelPalette(max, min);
+        uint64_t indices{};
+        for (size_t i{}; i < s_texelCount; i++) {
+            uint64_t bestIndex{};
+            int bestDistance{std::abs(texels[i][channel] - palette[0])};
+            for (uint64_t index{1}; index < (max == min ? 1u : 8u); index++) {
+                if (const int distance = std::abs(texels[i][channel] - palette[index]); distance < bestDistance) {
+                    bestIndex = index;
+                    bestDistance = distance;
+                }
+            }
+
+            indices |= bestIndex << (3 * i);
+        }
+
+        output[0] = max;
+        output[1] = min;
+        for (size_t i{}; i < 6; i++) {
+            output[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+        }
+    }
+
+    void decodeChannel(const uint8_t* input, Block& texels, const size_t channel) {
+        const auto palette = channelPalette(input[0], input[1]);
+        uint64_t indices{};
+        for (size_t i{}; i < 6; i++) {
+            indices |= static_cast<uint64_t>(input[2 + i]) << (8 * i);
+        }
+
+        for (size_t i{}; i < s_texelCount; i++) {
+            texels[i][channel] = palette[indices >> (3 * i) & 7];
+        }
+    }
+}
+
+size_t Engine::Renderer::BlockCompression::levelBytes(const Format format, const glm::ivec2 size) {
+    if (format == Format::RGBA8) {
+        return static_cast<size_t>(size.x) * static_cast<size_t>(size.y) * 4;
+    }
+
+    const auto blocks = blockCount(size);
+    return static_cast<size_t>(blocks.x) * static_cast<size_t>(blocks.y) * bytesPerBlock(format);
+}
+
+const char* Engine::Renderer::BlockCompression::toString(const Format format) {
+    switch (format) {
+        case Format::RGBA8: return "RGBA8";
+        case Format::BC1: return "BC1";
+        case Format::BC3: return "BC3";
+        case Format::BC4: return "BC4";
+        case Format::BC5: return "BC5";
+        case Format::BC7: return "BC7";
+    }
+
+    return "unknown";
+}
+
+Engine::Renderer::BlockCompression::Format Engine::Renderer::BlockCompression::choose(
+    const std::span<const uint8_t> rgba) {
+    bool grey{true};
+    bool opaque{true};
+    for (size_t i{}; i + 3 < rgba.size(); i += 4) {
+        grey = grey && std::abs(rgba[i] - rgba[i + 1]) <= s_greyTolerance &&
+               std::abs(rgba[i + 1] - rgba[i + 2]) <= s_greyTolerance;
+        opaque = opaque && rgba[i + 3] == 255;
+    }
+
+    if (!opaque) {
+        return Format::BC3;
+    }
+
+    return grey ? Format::BC4 : Format::BC1;
+}
+
+std::vector<uint8_t> Engine::Renderer::BlockCompression::encode(const Format format,
+                                                                const std::span<const uint8_t> rgba,
+                                                                const glm::ivec2 size) {
+    if (format == Format::RGBA8 || format == Format::BC7) {
+        return {};
+    }
+
+    ASSERT(rgba.size() >= levelBytes(Format::RGBA8, size));
+    const auto blocks = blockCount(size);
+    std::vector<uint8_t> output(levelBytes(format, size));
+    uint8_t* block = output.data();
+    for (int y{}; y < blocks.y; y++) {
+        for (int x{}; x < blocks.x; x++) {
+            const auto texels = fetchBlock(rgba, size, glm::ivec2{x, y});
+            switch (format) {
+                case Format::BC1:
+                    encodeColor(texels, block);
+                    break;
+                case Format::BC3:
+                    encodeChannel(texels, 3, block);
+                    encodeColor(texels, block + 8);
+                    break;
+                case Format::BC4:
+                    encodeChannel(texels, 0, block);
+                    break;
+                case Format::BC5:
+                    encodeChannel(texels, 0, block);
+                    encodeChannel(texels, 1, block + 8);
+                    break;
+                case Format::RGBA8:
+                case Format::BC7:
+                    break;
+            }
+
+            block += bytesPerBlock(format);
+        }
+    }
+
+    return output;
+}
+
+std::vector<uint8_t> Engine::Renderer::BlockCompression::decode(const Format format,
+                                                                const std::span<const uint8_t> blocks,
+                                                                const glm::ivec2 size) {
+    if (format == Format::RGBA8 || format == Format::BC7) {
+        return {};
+    }
+
+    ASSERT(blocks.size() >= levelBytes(format, size));
+    const auto count = blockCount(size);
+    std::vector<uint8_t> rgba(levelBytes(Format::RGBA8, size));
+    const uint8_t* block = blocks.data();
+    for (int y{}; y < count.y; y++) {
+        for (int x{}; x < count.x; x++) {
+            Block texels{};
+            for (auto& texel: texels) {
+                texel = Texel{0, 0, 0, 255};
+            }
+
+            switch (format) {
+                case Format::BC1:
+                    decodeColor(block, texels, true);
+                    break;
+                case Format::BC3:
+                    decodeChannel(block, texels, 3);
+                    decodeColor(block + 8, texels, false);
+                    break;
+                case Format::BC4:
+                    decodeChannel(block, texels, 0);
+                    for (auto& texel: texels) {
+                        texel[1] = texel[0];
+                        texel[2] = texel[0];
+                    }
+                    break;
+                case Format::BC5:
+                    decodeChannel(block, texels, 0);
+                    decodeChannel(block + 8, texels, 1);
+                    break;
+                case Format::RGBA8:
+                case Format::BC7:
+                    break;
+            }
+
+            storeBlock(texels, rgba, size, glm::ivec2{x, y});
+            block += bytesPerBlock(format);
+        }
+    }
+
+    return rgba;
+}
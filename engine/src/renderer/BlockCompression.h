@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/vec2.hpp>
+
+// 4x4 block compressed texture formats, encoded on the cpu when textures are cooked. The gpu samples them without
+// decompressing, so they save bandwidth as well as memory:
+// - BC1: RGB, 8 bytes per block, 8x smaller than RGBA8
+// - BC3: BC1 color plus BC4 alpha, 16 bytes per block
+// - BC4: one channel, 8 bytes per block. Masks and greyscale maps, swizzled to RRR1 when sampled
+// - BC5: two BC4 channels, 16 bytes per block. Normal maps
+// - BC7: 16 bytes per block, only loaded, never encoded here
+namespace Engine::Renderer::BlockCompression {
+    enum class Format : uint8_t {
+        RGBA8,
+        BC1,
+        BC3,
+        BC4,
+        BC5,
+        BC7
+    };
+
+    inline constexpr uint32_t s_blockSize{4};
+
+    [[nodiscard]] constexpr uint32_t bytesPerBlock(const Format format) {
+        switch (format) {
+            case Format::BC1:
+            case Format::BC4:
+                return 8;
+            case Format::BC3:
+            case Format::BC5:
+            case Format::BC7:
+                return 16;
+            case Format::RGBA8:
+                return s_blockSize * s_blockSize * 4;
+        }
+
+        return 0;
+    }
+
+    // Of one mip level. Partial blocks at the edges count in full, RGBA8 is not padded.
+    [[nodiscard]] size_t levelBytes(Format format, glm::ivec2 size);
+
+    [[nodiscard]] const char* toString(Format format);
+
+    // The smallest format that keeps what is in the image: BC4 for greyscale, BC1 for opaque and BC3 otherwise
+    [[nodiscard]] Format choose(std::span<const uint8_t> rgba);
+
+    // Takes RGBA8, empty for RGBA8 and BC7
+    [[nodiscard]] std::vector<uint8_t> encode(Format format, std::span<const uint8_t> rgba, glm::ivec2 size);
+
+    // Back to RGBA8, for drivers without the format. Empty for BC7.
+    [[nodiscard]] std::vector<uint8_t> decode(Format format, std::span<const uint8_t> blocks, glm::ivec2 size);
+}
@@ -6,7 +6,10 @@
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
 
+#include <limits>
+
 #include "core/Math.h"
+#include "renderer/shader/UniformBlock.h"
 
 namespace Engine::Renderer {
     class Camera {
@@ -42,6 +45,10 @@ namespace Engine::Renderer {
             return m_position;
         }
 
+        [[nodiscard]] Shader::CameraBlock getBlock() const {
+            return {m_view, m_projection, m_position};
+        }
+
         void updateViewMatrix() {
             m_view = glm::lookAt(m_position, m_position + m_direction, Math::Vec3::up);
         }
@@ -89,6 +96,16 @@ namespace Engine::Renderer {
             setDirection(glm::normalize(direction));
         }
 
+        // Diameter of a bounding sphere on screen, as a fraction of the screen height
+        [[nodiscard]] float projectedSize(const glm::vec3& center, const float radius) const {
+            const float distance = glm::length(center - m_position);
+            if (distance <= radius) {
+                return std::numeric_limits<float>::max();
+            }
+
+            return radius * m_projection[1][1] / distance;
+        }
+
         void debugMove(const double deltaTime, const float moveSpeed, const float mouseSensitivity);
 
     private:
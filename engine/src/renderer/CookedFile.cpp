@@ -0,0 +1,94 @@
+#include "CookedFile.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#include "core/Hash.h"
+#include "core/Log.h"
+#include "core/MappedFile.h"
+
+std::optional<Engine::Renderer::CookedFile::SourceInfo> Engine::Renderer::CookedFile::getSourceInfo(
+    const std::string& sourcePath) {
+    std::error_code error;
+    const auto size = std::filesystem::file_size(sourcePath, error);
+    if (error) {
+        return std::nullopt;
+    }
+
+    const auto mtime = std::filesystem::last_write_time(sourcePath, error);
+    if (error) {
+        return std::nullopt;
+    }
+
+    return SourceInfo{size, static_cast<int64_t>(mtime.time_since_epoch().count())};
+}
+
+Engine::Renderer::CookedFile::Freshness Engine::Renderer::CookedFile::check(const std::string& sourcePath,
+                                                                            const SourceInfo& recorded,
+                                                                            const uint64_t recordedHash) {
+    const auto sourceInfo = getSourceInfo(sourcePath);
+    if (!sourceInfo) {
+        return Freshness::FRESH;
+    }
+
+    if (sourceInfo->size != recorded.size) {
+        return Freshness::STALE;
+    }
+
+    if (sourceInfo->mtime == recorded.mtime) {
+        return Freshness::FRESH;
+    }
+
+    // Touched but maybe not changed. Only hash the source when the cheap checks disagree
+    const MappedFile source{sourcePath};
+    if (!source.isOpen() || Hash::bytes(source.data(), source.size()) != recordedHash) {
+        return Freshness::STALE;
+    }
+
+    return Freshness::TOUCHED;
+}
+
+bool Engine::Renderer::CookedFile::updateMtime(const std::string& cookedPath, const size_t mtimeOffset,
+                                               const std::string& sourcePath) {
+    const auto sourceInfo = getSourceInfo(sourcePath);
+    if (!sourceInfo) {
+        return false;
+    }
+
+    std::fstream file{cookedPath, std::ios::binary | std::ios::in | std::ios::out};
+    file.seekp(static_cast<std::streamoff>(mtimeOffset));
+    file.write(reinterpret_cast<const char*>(&sourceInfo->mtime), sizeof(sourceInfo->mtime));
+    return static_cast<bool>(file);
+}
+
+bool Engine::Renderer::CookedFile::write(const std::string& cookedPath, const std::span<const uint8_t> bytes) {
+    const std::filesystem::path path{cookedPath};
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    // Unique per write, two threads or processes cooking the same file must not truncate each other's temp file
+    static std::atomic<uint32_t> s_writeCount;
+    const auto tempPath = std::filesystem::path{path}.concat(
+        '.' + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + '-' +
+        std::to_string(s_writeCount++) + ".tmp");
+    {
+        std::ofstream file{tempPath, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            LOG_ERR("Could not write cooked file: " << tempPath.string() << '\n');
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_ERR("Could not move cooked file into place: " << cookedPath << '\n');
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace Engine::Renderer::CookedFile {
+    // What a cooked file was built from, kept in it together with a hash of the source contents
+    struct SourceInfo {
+        uint64_t size{};
+        int64_t mtime{};
+    };
+
+    enum class Freshness : uint8_t {
+        FRESH,
+        TOUCHED, // Same contents under a new modification time, the recorded one should be updated
+        STALE
+    };
+
+    [[nodiscard]] std::optional<SourceInfo> getSourceInfo(const std::string& sourcePath);
+
+    // Compares the source against what a cooked file recorded of it, the contents are only hashed when the
+    // modification time disagrees. A missing source leaves the cooked file fresh, there is nothing to rebuild from.
+    [[nodiscard]] Freshness check(const std::string& sourcePath, const SourceInfo& recorded, uint64_t recordedHash);
+
+    // Overwrites the recorded modification time at mtimeOffset with the source's current one, so the next check of a
+    // TOUCHED file is cheap again. Not while the file is mapped, and not concurrently with other writes of it. False if
+    // it could not be written.
+    bool updateMtime(const std::string& cookedPath, size_t mtimeOffset, const std::string& sourcePath);
+
+    // Written next to the target under a temp name of its own and renamed, so a crash never leaves a half written
+    // file behind. Concurrent writes of one path do not corrupt it, the last rename wins.
+    bool write(const std::string& cookedPath, std::span<const uint8_t> bytes);
+}
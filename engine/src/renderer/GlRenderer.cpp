@@ -4,9 +4,13 @@
 #include <glad/glad.h>
 #include <SDL3/SDL_init.h>
 
+#include "RenderQueue.h"
+#include "Sampler.h"
+#include "Texture.h"
 #include "VertexArray.h"
 #include "buffer/Index.h"
 #include "shader/Program.h"
+#include "shader/UniformBlock.h"
 #include "core/Window.h"
 
 Engine::Window Engine::Renderer::GlRenderer::createWindow(const std::string& name, const int width, const int height) {
@@ -53,12 +57,59 @@ Engine::Renderer::GlRenderer::GlRenderer(const Window& window) : m_context(
     LOG("GL Version: " << RENDERER_API_CALL_RETURN(glGetString(GL_VERSION)) << '\n');
     LOG("GLSL Version: " << RENDERER_API_CALL_RETURN(glGetString(GL_SHADING_LANGUAGE_VERSION)) << '\n');
 
+#ifdef GL_ARB_buffer_storage
+    m_capabilities.bufferStorage = GLAD_GL_ARB_buffer_storage != 0;
+#endif
+    LOG("Persistent mapped buffers: " << (m_capabilities.bufferStorage ? "yes" : "no") << '\n');
+
+#ifdef GL_ARB_get_program_binary
+    // Some drivers expose the extension without offering a single format
+    if (GLAD_GL_ARB_get_program_binary != 0) {
+        GLint formats{};
+        RENDERER_API_CALL(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+        m_capabilities.programBinary = formats > 0;
+    }
+#endif
+    LOG("Program binaries: " << (m_capabilities.programBinary ? "yes" : "no") << '\n');
+
+#ifdef GL_KHR_parallel_shader_compile
+    m_capabilities.parallelShaderCompile = GLAD_GL_KHR_parallel_shader_compile != 0;
+    if (m_capabilities.parallelShaderCompile) {
+        // As many compiler threads as the driver sees fit
+        RENDERER_API_CALL(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+    }
+#endif
+    LOG("Parallel shader compile: " << (m_capabilities.parallelShaderCompile ? "yes" : "no") << '\n');
+
+#ifdef GL_EXT_texture_filter_anisotropic
+    if (GLAD_GL_EXT_texture_filter_anisotropic != 0) {
+        RENDERER_API_CALL(glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &m_capabilities.maxAnisotropy));
+    }
+#endif
+    LOG("Max anisotropy: " << m_capabilities.maxAnisotropy << '\n');
+
+#ifdef GL_EXT_texture_compression_s3tc
+    m_capabilities.compressionS3tc = GLAD_GL_EXT_texture_compression_s3tc != 0;
+#endif
+#ifdef GL_ARB_texture_compression_bptc
+    m_capabilities.compressionBptc = GLAD_GL_ARB_texture_compression_bptc != 0;
+#endif
+    LOG("Compressed textures: BC1/BC3 " << (m_capabilities.compressionS3tc ? "yes" : "no") << ", BC7 " << (
+        m_capabilities.compressionBptc ? "yes" : "no") << '\n');
+
     // Temporary blend mode set
-    RENDERER_API_CALL(glEnable(GL_BLEND));
-    RENDERER_API_CALL(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
-    RENDERER_API_CALL(glEnable(GL_CULL_FACE));
-    RENDERER_API_CALL(glCullFace(GL_BACK));
-    RENDERER_API_CALL(glEnable(GL_DEPTH_TEST));
+    m_state.setBlend(true);
+    m_state.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    m_state.setCulling(true);
+    m_state.setCullFace(GL_BACK);
+    m_state.setDepthTest(true);
+
+    m_cameraBlock.emplace(static_cast<uint32_t>(sizeof(Shader::CameraBlock)),
+                          static_cast<uint32_t>(Shader::BlockBinding::CAMERA));
+    m_lightBlock.emplace(static_cast<uint32_t>(sizeof(Shader::LightBlock)),
+                         static_cast<uint32_t>(Shader::BlockBinding::LIGHTS));
+    m_textureLoader.emplace();
+    m_resourceCache.emplace();
 }
 
 void Engine::Renderer::GlRenderer::clearErrors() const {
@@ -83,7 +134,10 @@ void* Engine::Renderer::GlRenderer::getContext() const {
 }
 
 void Engine::Renderer::GlRenderer::swapWindow(const Window& window) const {
+    m_textureLoader->update();
+    m_resourceCache->collect();
     SDL_GL_SwapWindow(window.getSdlWindow());
+    m_state.endFrame();
 }
 
 void Engine::Renderer::GlRenderer::clear(const glm::vec4 color) const {
@@ -97,3 +151,70 @@ void Engine::Renderer::GlRenderer::draw(const VertexArray& vertexArray,
     shaderProgram.bind();
     RENDERER_API_CALL(glDrawElements(GL_TRIANGLES, vertexArray.getIndexBuffer().getCount(), GL_UNSIGNED_INT, nullptr));
 }
+
+void Engine::Renderer::GlRenderer::drawInstanced(const VertexArray& vertexArray, const Shader::Program& shaderProgram,
+                                                 const uint32_t instanceCount) const {
+    ASSERT_MSG(vertexArray.isInstantiable(), "Vertex array cannot be drawn instanced. No instance buffer is set.");
+
+    vertexArray.bind();
+    shaderProgram.bind();
+    RENDERER_API_CALL(
+        glDrawElementsInstanced(GL_TRIANGLES, vertexArray.getIndexBuffer().getCount(), GL_UNSIGNED_INT, nullptr,
+            instanceCount));
+}
+
+void Engine::Renderer::GlRenderer::setCamera(const Shader::CameraBlock& camera) const {
+    m_cameraBlock->update(camera);
+}
+
+void Engine::Renderer::GlRenderer::setLights(const Shader::LightBlock& lights) const {
+    m_lightBlock->update(lights);
+}
+
+void Engine::Renderer::GlRenderer::draw(RenderQueue& renderQueue) const {
+    renderQueue.sort();
+
+    // Elides the same binds RenderQueue counts in its stats
+    const VertexArray* boundVertexArray{};
+    std::array<Id, RenderQueue::s_textureSlots> boundTextures{};
+
+    const auto packets = renderQueue.getPackets();
+    for (const uint32_t index: renderQueue.getOrder()) {
+        const auto& packet = packets[index];
+        if (packet.applyUniforms != nullptr) {
+            packet.applyUniforms(*packet.program, packet);
+        }
+
+        // Uploads the uniforms the packet changed, the program itself is only switched when it differs
+        packet.program->bind();
+
+        if (packet.vertexArray != boundVertexArray) {
+            packet.vertexArray->bind();
+            boundVertexArray = packet.vertexArray;
+        }
+
+        for (uint32_t slot{}; slot < RenderQueue::s_textureSlots; slot++) {
+            const auto* texture = packet.textures[slot];
+            if (texture == nullptr) {
+                continue;
+            }
+
+            if (texture->getSource().getId() != boundTextures[slot]) {
+                texture->bind(slot);
+                boundTextures[slot] = texture->getSource().getId();
+            }
+
+            const auto* sampler = packet.samplers[slot];
+            m_state.bindSampler(slot, sampler != nullptr ? sampler->getId() : 0);
+        }
+
+        const uint32_t indexCount = packet.indexCount != 0
+                                        ? packet.indexCount
+                                        : packet.vertexArray->getIndexBuffer().getCount();
+        RENDERER_API_CALL(
+            glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT,
+                reinterpret_cast<const void*>(packet.indexOffset * sizeof(uint32_t))));
+    }
+
+    renderQueue.clear();
+}
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <optional>
 #include <glm/vec4.hpp>
 #include <SDL3/SDL_video.h>
 
+#include "GlState.h"
 #include "Renderer.h"
+#include "ResourceCache.h"
+#include "TextureLoader.h"
+#include "buffer/Uniform.h"
 
 namespace Engine::Renderer {
     class GlRenderer final : public Renderer {
@@ -16,21 +21,16 @@ namespace Engine::Renderer {
 
         GlRenderer& operator=(const GlRenderer&) = delete;
 
-        GlRenderer(GlRenderer&& other) noexcept : m_context(other.m_context) {
-            other.m_context = {};
-        }
-
-        GlRenderer& operator=(GlRenderer&& other) noexcept {
-            if (&other == this) {
-                return *this;
-            }
+        // Owns GL objects tied to its context, only ever held through a unique_ptr
+        GlRenderer(GlRenderer&&) = delete;
 
-            m_context = other.m_context;
-            other.m_context = {};
-            return *this;
-        }
+        GlRenderer& operator=(GlRenderer&&) = delete;
 
         ~GlRenderer() override {
+            m_resourceCache.reset();
+            m_textureLoader.reset();
+            m_cameraBlock.reset();
+            m_lightBlock.reset();
             SDL_GL_DestroyContext(m_context);
         }
 
@@ -50,8 +50,34 @@ namespace Engine::Renderer {
 
         void draw(const VertexArray& vertexArray, const Shader::Program& shaderProgram) const override;
 
+        void drawInstanced(const VertexArray& vertexArray, const Shader::Program& shaderProgram,
+                           uint32_t instanceCount) const override;
+
+        void draw(RenderQueue& renderQueue) const override;
+
+        void setCamera(const Shader::CameraBlock& camera) const override;
+
+        void setLights(const Shader::LightBlock& lights) const override;
+
+        [[nodiscard]] GlState& getState() const {
+            return m_state;
+        }
+
+        [[nodiscard]] TextureLoader& getTextureLoader() const {
+            return *m_textureLoader;
+        }
+
+        [[nodiscard]] ResourceCache& getResourceCache() const {
+            return *m_resourceCache;
+        }
+
     private:
         SDL_GLContext m_context{};
+        mutable GlState m_state; // Binding is not a change to the renderer itself
+        std::optional<Buffer::Uniform> m_cameraBlock;
+        std::optional<Buffer::Uniform> m_lightBlock;
+        mutable std::optional<TextureLoader> m_textureLoader; // Streaming textures in is not a change either
+        mutable std::optional<ResourceCache> m_resourceCache;
         bool m_glLoaderInitialized{};
     };
 }
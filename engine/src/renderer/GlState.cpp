@@ -0,0 +1,248 @@
+#include "GlState.h"
+
+#include "GlRenderer.h"
+#include "Renderer.h"
+
+Engine::Renderer::GlState& Engine::Renderer::GlState::current() {
+    auto* renderer = Renderer::getActiveRenderer();
+    ASSERT_MSG(renderer != nullptr, "No active renderer to track the state of.");
+    return static_cast<GlRenderer*>(renderer)->getState();
+}
+
+std::optional<Engine::Renderer::GlState::BufferTarget> Engine::Renderer::GlState::toBufferTarget(const GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER: return BufferTarget::ARRAY;
+        case GL_ELEMENT_ARRAY_BUFFER: return BufferTarget::ELEMENT_ARRAY;
+        case GL_UNIFORM_BUFFER: return BufferTarget::UNIFORM;
+        case GL_PIXEL_UNPACK_BUFFER: return BufferTarget::PIXEL_UNPACK;
+        case GL_PIXEL_PACK_BUFFER: return BufferTarget::PIXEL_PACK;
+        case GL_COPY_READ_BUFFER: return BufferTarget::COPY_READ;
+        case GL_COPY_WRITE_BUFFER: return BufferTarget::COPY_WRITE;
+        default: return std::nullopt;
+    }
+}
+
+std::optional<Engine::Renderer::GlState::TextureTarget>
+Engine::Renderer::GlState::toTextureTarget(const GLenum target) {
+    switch (target) {
+        case GL_TEXTURE_2D: return TextureTarget::TEXTURE_2D;
+        case GL_TEXTURE_2D_ARRAY: return TextureTarget::TEXTURE_2D_ARRAY;
+        case GL_TEXTURE_CUBE_MAP: return TextureTarget::TEXTURE_CUBE_MAP;
+        default: return std::nullopt;
+    }
+}
+
+bool Engine::Renderer::GlState::skip(const bool unchanged) {
+    if (unchanged) {
+        m_stats.skipped++;
+    } else {
+        m_stats.calls++;
+    }
+
+    return unchanged;
+}
+
+void Engine::Renderer::GlState::bindVertexArray(const Id id) {
+    if (skip(m_vertexArray == id)) {
+        return;
+    }
+
+    RENDERER_API_CALL(glBindVertexArray(id));
+    m_vertexArray = id;
+    // The element array binding belongs to the vertex array
+    m_buffers[static_cast<size_t>(BufferTarget::ELEMENT_ARRAY)] = s_unknown;
+}
+
+void Engine::Renderer::GlState::bindBuffer(const GLenum target, const Id id) {
+    const auto tracked = toBufferTarget(target);
+    if (skip(tracked.has_value() && m_buffers[static_cast<size_t>(*tracked)] == id)) {
+        return;
+    }
+
+    RENDERER_API_CALL(glBindBuffer(target, id));
+    if (tracked.has_value()) {
+        m_buffers[static_cast<size_t>(*tracked)] = id;
+    }
+}
+
+void Engine::Renderer::GlState::bindBufferBase(const GLenum target, const uint32_t index, const Id id) {
+    const bool tracked = target == GL_UNIFORM_BUFFER && index < s_uniformBindings;
+    if (skip(tracked && m_uniformBindings[index] == id
+             && m_buffers[static_cast<size_t>(BufferTarget::UNIFORM)] == id)) {
+        return;
+    }
+
+    RENDERER_API_CALL(glBindBufferBase(target, index, id));
+    if (tracked) {
+        m_uniformBindings[index] = id;
+    }
+
+    if (const auto generic = toBufferTarget(target); generic.has_value()) {
+        m_buffers[static_cast<size_t>(*generic)] = id;
+    }
+}
+
+void Engine::Renderer::GlState::activeTexture(const uint32_t unit) {
+    if (skip(m_activeUnit == unit)) {
+        return;
+    }
+
+    RENDERER_API_CALL(glActiveTexture(GL_TEXTURE0 + unit));
+    m_activeUnit = unit;
+}
+
+void Engine::Renderer::GlState::bindTexture(const uint32_t unit, const GLenum target, const Id id) {
+    ASSERT(unit < s_textureUnits);
+    const auto tracked = toTextureTarget(target);
+    if (tracked.has_value() && m_textures[unit][static_cast<size_t>(*tracked)] == id) {
+        skip(true);
+        return;
+    }
+
+    activeTexture(unit);
+    skip(false);
+    RENDERER_API_CALL(glBindTexture(target, id));
+    if (tracked.has_value()) {
+        m_textures[unit][static_cast<size_t>(*tracked)] = id;
+    }
+}
+
+void Engine::Renderer::GlState::bindSampler(const uint32_t unit, const Id id) {
+    ASSERT(unit < s_textureUnits);
+    if (skip(m_samplers[unit] == id)) {
+        return;
+    }
+
+    RENDERER_API_CALL(glBindSampler(unit, id));
+    m_samplers[unit] = id;
+}
+
+void Engine::Renderer::GlState::useProgram(const Id id) {
+    if (skip(m_program == id)) {
+        return;
+    }
+
+    RENDERER_API_CALL(glUseProgram(id));
+    m_program = id;
+}
+
+void Engine::Renderer::GlState::setEnabled(const GLenum capability, std::optional<bool>& current, const bool enabled) {
+    if (skip(current == enabled)) {
+        return;
+    }
+
+    if (enabled) {
+        RENDERER_API_CALL(glEnable(capability));
+    } else {
+        RENDERER_API_CALL(glDisable(capability));
+    }
+    current = enabled;
+}
+
+void Engine::Renderer::GlState::setBlend(const bool enabled) {
+    setEnabled(GL_BLEND, m_blend, enabled);
+}
+
+void Engine::Renderer::GlState::setBlendFunc(const GLenum source, const GLenum destination) {
+    if (skip(m_blendFunc == std::pair{source, destination})) {
+        return;
+    }
+
+    RENDERER_API_CALL(glBlendFunc(source, destination));
+    m_blendFunc = std::pair{source, destination};
+}
+
+void Engine::Renderer::GlState::setCulling(const bool enabled) {
+    setEnabled(GL_CULL_FACE, m_culling, enabled);
+}
+
+void Engine::Renderer::GlState::setCullFace(const GLenum face) {
+    if (skip(m_cullFace == face)) {
+        return;
+    }
+
+    RENDERER_API_CALL(glCullFace(face));
+    m_cullFace = face;
+}
+
+void Engine::Renderer::GlState::setDepthTest(const bool enabled) {
+    setEnabled(GL_DEPTH_TEST, m_depthTest, enabled);
+}
+
+void Engine::Renderer::GlState::setDepthWrite(const bool enabled) {
+    if (skip(m_depthWrite == enabled)) {
+        return;
+    }
+
+    RENDERER_API_CALL(glDepthMask(enabled ? GL_TRUE : GL_FALSE));
+    m_depthWrite = enabled;
+}
+
+void Engine::Renderer::GlState::onVertexArrayDeleted(const Id id) {
+    if (m_vertexArray == id) {
+        m_vertexArray = 0;
+        m_buffers[static_cast<size_t>(BufferTarget::ELEMENT_ARRAY)] = s_unknown;
+    }
+}
+
+void Engine::Renderer::GlState::onBufferDeleted(const Id id) {
+    for (auto& buffer: m_buffers) {
+        if (buffer == id) {
+            buffer = 0;
+        }
+    }
+
+    for (auto& binding: m_uniformBindings) {
+        if (binding == id) {
+            binding = 0;
+        }
+    }
+}
+
+void Engine::Renderer::GlState::onTextureDeleted(const Id id) {
+    for (auto& unit: m_textures) {
+        for (auto& texture: unit) {
+            if (texture == id) {
+                texture = 0;
+            }
+        }
+    }
+}
+
+void Engine::Renderer::GlState::onSamplerDeleted(const Id id) {
+    for (auto& sampler: m_samplers) {
+        if (sampler == id) {
+            sampler = 0;
+        }
+    }
+}
+
+void Engine::Renderer::GlState::onProgramDeleted(const Id id) {
+    // A program deleted while in use stays bound until another one is used, while a new program may get its name
+    if (m_program == id) {
+        m_program = s_unknown;
+    }
+}
+
+void Engine::Renderer::GlState::invalidate() {
+    m_vertexArray = s_unknown;
+    m_program = s_unknown;
+    m_buffers.fill(s_unknown);
+    m_uniformBindings.fill(s_unknown);
+    for (auto& unit: m_textures) {
+        unit.fill(s_unknown);
+    }
+    m_samplers.fill(s_unknown);
+    m_activeUnit = s_unknown;
+    m_blend.reset();
+    m_blendFunc.reset();
+    m_culling.reset();
+    m_cullFace.reset();
+    m_depthTest.reset();
+    m_depthWrite.reset();
+}
+
+void Engine::Renderer::GlState::endFrame() {
+    m_lastFrameStats = m_stats;
+    m_stats = {};
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <utility>
+#include <glad/glad.h>
+
+#include "core/Typedef.h"
+
+namespace Engine::Renderer {
+    // Shadow of the state of one GL context, owned by its GlRenderer. Every bind and toggle goes through it, so calls
+    // that would not change anything never reach the driver.
+    class GlState {
+    public:
+        static constexpr uint32_t s_textureUnits{16};
+        static constexpr uint32_t s_uniformBindings{16}; // Tracked ones, GL guarantees at least 36
+
+        struct Stats {
+            uint32_t calls{};
+            uint32_t skipped{};
+        };
+
+        // State of the active renderer's context
+        static GlState& current();
+
+        void bindVertexArray(Id id);
+
+        void bindBuffer(GLenum target, Id id);
+
+        // Binds to the indexed binding point and the generic binding of the target, like GL does
+        void bindBufferBase(GLenum target, uint32_t index, Id id);
+
+        void bindTexture(uint32_t unit, GLenum target, Id id);
+
+        // 0 leaves sampling to the parameters of the texture itself
+        void bindSampler(uint32_t unit, Id id);
+
+        void useProgram(Id id);
+
+        void setBlend(bool enabled);
+
+        void setBlendFunc(GLenum source, GLenum destination);
+
+        void setCulling(bool enabled);
+
+        void setCullFace(GLenum face);
+
+        void setDepthTest(bool enabled);
+
+        void setDepthWrite(bool enabled);
+
+        // GL unbinds deleted objects, and hands their names out again
+        void onVertexArrayDeleted(Id id);
+
+        void onBufferDeleted(Id id);
+
+        void onTextureDeleted(Id id);
+
+        void onSamplerDeleted(Id id);
+
+        void onProgramDeleted(Id id);
+
+        // Forgets everything, for when code outside the engine changed the context
+        void invalidate();
+
+        // Moves the counters of the frame that just ended to getLastFrameStats()
+        void endFrame();
+
+        [[nodiscard]] const Stats& getLastFrameStats() const {
+            return m_lastFrameStats;
+        }
+
+    private:
+        static constexpr Id s_unknown{~Id{}};
+
+        // Buffer and texture targets that are tracked, anything else always reaches the driver
+        enum class BufferTarget : uint8_t {
+            ARRAY, ELEMENT_ARRAY, UNIFORM, PIXEL_UNPACK, PIXEL_PACK, COPY_READ, COPY_WRITE, COUNT
+        };
+
+        enum class TextureTarget : uint8_t {
+            TEXTURE_2D, TEXTURE_2D_ARRAY, TEXTURE_CUBE_MAP, COUNT
+        };
+
+        static std::optional<BufferTarget> toBufferTarget(GLenum target);
+
+        static std::optional<TextureTarget> toTextureTarget(GLenum target);
+
+        // Counts the call, returns true if it can be skipped
+        bool skip(bool unchanged);
+
+        void setEnabled(GLenum capability, std::optional<bool>& current, bool enabled);
+
+        void activeTexture(uint32_t unit);
+
+        // Defaults of a fresh context
+        Id m_vertexArray{};
+        Id m_program{};
+        std::array<Id, static_cast<size_t>(BufferTarget::COUNT)> m_buffers{};
+        std::array<Id, s_uniformBindings> m_uniformBindings{};
+        std::array<std::array<Id, static_cast<size_t>(TextureTarget::COUNT)>, s_textureUnits> m_textures{};
+        std::array<Id, s_textureUnits> m_samplers{};
+        uint32_t m_activeUnit{};
+        std::optional<bool> m_blend{false};
+        std::optional<std::pair<GLenum, GLenum>> m_blendFunc{std::pair<GLenum, GLenum>{GL_ONE, GL_ZERO}};
+        std::optional<bool> m_culling{false};
+        std::optional<GLenum> m_cullFace{GL_BACK};
+        std::optional<bool> m_depthTest{false};
+        std::optional<bool> m_depthWrite{true};
+
+        Stats m_stats;
+        Stats m_lastFrameStats;
+    };
+}
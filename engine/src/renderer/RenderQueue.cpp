@@ -0,0 +1,127 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+
+#include "Texture.h"
+#include "VertexArray.h"
+#include "core/Assert.h"
+#include "shader/Program.h"
+
+namespace {
+    using Engine::Renderer::RenderQueue;
+
+    uint64_t bits(const uint64_t value, const uint32_t width) {
+        return value & ((uint64_t{1} << width) - 1);
+    }
+
+    // Positive floats order like their bit patterns, keep the top 20 bits below the sign
+    uint64_t depthBits(const float depth) {
+        return bits(std::bit_cast<uint32_t>(std::max(depth, 0.f)) >> 11, 20);
+    }
+
+    // Least significant digit first radix sort of the indices by key, 8 bits per pass. Passes where every key has the
+    // same digit are skipped, so keys that only differ in a few fields stay cheap.
+    void radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& order, std::vector<uint64_t>& scratchKeys,
+                   std::vector<uint32_t>& scratchOrder) {
+        scratchKeys.resize(keys.size());
+        scratchOrder.resize(order.size());
+
+        for (uint32_t shift{}; shift < 64; shift += 8) {
+            std::array<uint32_t, 256> counts{};
+            for (const uint64_t key: keys) {
+                counts[(key >> shift) & 0xFF]++;
+            }
+
+            if (std::ranges::find(counts, static_cast<uint32_t>(keys.size())) != counts.end()) {
+                continue;
+            }
+
+            std::exclusive_scan(counts.begin(), counts.end(), counts.begin(), 0u);
+            for (size_t i{}; i < keys.size(); i++) {
+                const uint32_t destination = counts[(keys[i] >> shift) & 0xFF]++;
+                scratchKeys[destination] = keys[i];
+                scratchOrder[destination] = order[i];
+            }
+
+            keys.swap(scratchKeys);
+            order.swap(scratchOrder);
+        }
+    }
+}
+
+uint64_t Engine::Renderer::RenderQueue::sortKey(const Packet& packet) {
+    const uint64_t pass = bits(static_cast<uint64_t>(packet.pass), 2);
+    const uint64_t program = bits(packet.program->getId(), 12);
+    const uint64_t material = bits(packet.material, 12);
+    const uint64_t texture = packet.textures.front() != nullptr
+                                 ? bits(packet.textures.front()->getSource().getId(), 10)
+                                 : 0;
+    const uint64_t vertexArray = bits(packet.vertexArray->getId(), 8);
+    const uint64_t depth = depthBits(packet.depth);
+
+    if (packet.pass == Pass::TRANSPARENT) {
+        const uint64_t backToFront = bits(~depth, 20);
+        return pass << 62 | backToFront << 42 | program << 30 | material << 18 | texture << 8 | vertexArray;
+    }
+
+    return pass << 62 | program << 50 | material << 38 | texture << 28 | vertexArray << 20 | depth;
+}
+
+void Engine::Renderer::RenderQueue::submit(const Packet& packet) {
+    ASSERT_MSG(packet.vertexArray != nullptr && packet.program != nullptr,
+               "Render packets need a vertex array and a program");
+    m_packets.push_back(packet);
+}
+
+void Engine::Renderer::RenderQueue::sort() {
+    m_order.resize(m_packets.size());
+    std::iota(m_order.begin(), m_order.end(), 0u);
+
+    m_stats.packets = static_cast<uint32_t>(m_packets.size());
+    m_stats.unsorted = countStateChanges(m_order);
+
+    m_keys.resize(m_packets.size());
+    std::ranges::transform(m_packets, m_keys.begin(), sortKey);
+    radixSort(m_keys, m_order, m_scratchKeys, m_scratchOrder);
+
+    m_stats.sorted = countStateChanges(m_order);
+}
+
+void Engine::Renderer::RenderQueue::clear() {
+    m_packets.clear();
+    m_order.clear();
+}
+
+Engine::Renderer::RenderQueue::StateChanges Engine::Renderer::RenderQueue::countStateChanges(
+    const std::span<const uint32_t> order) const {
+    // Same elision rules as the replay in the renderer
+    StateChanges changes;
+    const VertexArray* vertexArray{};
+    const Shader::Program* program{};
+    std::array<Id, s_textureSlots> textures{};
+
+    for (const uint32_t index: order) {
+        const auto& packet = m_packets[index];
+        if (packet.program != program) {
+            program = packet.program;
+            changes.programs++;
+        }
+
+        if (packet.vertexArray != vertexArray) {
+            vertexArray = packet.vertexArray;
+            changes.vertexArrays++;
+        }
+
+        for (size_t slot{}; slot < s_textureSlots; slot++) {
+            if (const auto* texture = packet.textures[slot];
+                texture != nullptr && texture->getSource().getId() != textures[slot]) {
+                textures[slot] = texture->getSource().getId();
+                changes.textures++;
+            }
+        }
+    }
+
+    return changes;
+}
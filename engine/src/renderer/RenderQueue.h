@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/mat4x4.hpp>
+
+namespace Engine::Renderer {
+    class VertexArray;
+    class Texture;
+    class Sampler;
+
+    namespace Shader {
+        class Program;
+    }
+
+    // Draws collected over a frame. They are radix sorted by a 64 bit key, so Renderer::draw(RenderQueue&) can replay
+    // them with as few state changes as possible.
+    class RenderQueue {
+    public:
+        static constexpr size_t s_textureSlots{4};
+
+        enum class Pass : uint8_t {
+            OPAQUE = 0,
+            TRANSPARENT = 1, // Sorted back to front before anything else
+            OVERLAY = 2
+        };
+
+        struct Packet {
+            const VertexArray* vertexArray{};
+            const Shader::Program* program{};
+            std::array<const Texture*, s_textureSlots> textures{}; // Bound to the slot of their index
+            std::array<const Sampler*, s_textureSlots> samplers{}; // Per textured slot, none uses the texture's own
+            // Per draw uniforms, uploaded when the program binds for the draw. Usually only sets the transform.
+            void (*applyUniforms)(const Shader::Program& program, const Packet& packet){};
+            glm::mat4 transform{1.f};
+            uint16_t material{}; // Packets sharing textures and uniform values should share a material
+            float depth{}; // Distance to the camera
+            Pass pass{Pass::OPAQUE};
+            uint32_t indexOffset{};
+            uint32_t indexCount{}; // 0 draws the whole index buffer
+        };
+
+        struct StateChanges {
+            uint32_t vertexArrays{};
+            uint32_t programs{};
+            uint32_t textures{};
+
+            [[nodiscard]] uint32_t getTotal() const {
+                return vertexArrays + programs + textures;
+            }
+        };
+
+        struct Stats {
+            uint32_t packets{};
+            StateChanges unsorted; // Had the packets been replayed in submission order
+            StateChanges sorted;
+        };
+
+        // pass | program | material | texture | vertex array | depth, depth moves up behind the pass when transparent
+        static uint64_t sortKey(const Packet& packet);
+
+        void submit(const Packet& packet);
+
+        // Sorts the packets and counts the state changes of both orders
+        void sort();
+
+        void clear();
+
+        [[nodiscard]] std::span<const Packet> getPackets() const {
+            return m_packets;
+        }
+
+        // Packet indices in draw order, valid after sort()
+        [[nodiscard]] std::span<const uint32_t> getOrder() const {
+            return m_order;
+        }
+
+        // Of the last sorted frame
+        [[nodiscard]] const Stats& getStats() const {
+            return m_stats;
+        }
+
+    private:
+        [[nodiscard]] StateChanges countStateChanges(std::span<const uint32_t> order) const;
+
+        std::vector<Packet> m_packets;
+        std::vector<uint32_t> m_order;
+        std::vector<uint64_t> m_keys;
+        std::vector<uint64_t> m_scratchKeys;
+        std::vector<uint32_t> m_scratchOrder;
+        Stats m_stats;
+    };
+}
@@ -12,6 +12,7 @@ namespace Engine {
 
 namespace Engine::Renderer {
     class GlRenderer;
+    class RenderQueue;
     class VertexArray;
 
     namespace Buffer {
@@ -20,6 +21,8 @@ namespace Engine::Renderer {
 
     namespace Shader {
         class Program;
+        struct CameraBlock;
+        struct LightBlock;
     }
 
     enum class Type : uint8_t {
@@ -40,6 +43,16 @@ namespace Engine::Renderer {
 
     class Renderer {
     public:
+        // Optional features of the active api, filled in once the context exists
+        struct Capabilities {
+            bool bufferStorage{}; // Persistently mapped buffers
+            bool programBinary{}; // Linked programs can be saved and loaded, see ProgramCache
+            bool parallelShaderCompile{}; // Compile and link status can be polled, see ProgramFuture
+            float maxAnisotropy{1.f}; // 1 without anisotropic filtering
+            bool compressionS3tc{}; // BC1 and BC3, BC4 and BC5 are core
+            bool compressionBptc{}; // BC7
+        };
+
         static Renderer* getActiveRenderer() {
             return s_ActiveRenderer;
         }
@@ -94,8 +107,27 @@ namespace Engine::Renderer {
 
         virtual void draw(const VertexArray& vertexArray, const Shader::Program& shaderProgram) const = 0;
 
+        // Draws the instances last committed to the vertex array's instance buffer
+        virtual void drawInstanced(const VertexArray& vertexArray, const Shader::Program& shaderProgram,
+                                   uint32_t instanceCount) const = 0;
+
+        // Sorts the queued packets, draws them with redundant binds left out and empties the queue
+        virtual void draw(RenderQueue& renderQueue) const = 0;
+
+        // Per frame data shared by every program through its uniform blocks, one upload no matter how many programs
+        // read it
+        virtual void setCamera(const Shader::CameraBlock& camera) const = 0;
+
+        virtual void setLights(const Shader::LightBlock& lights) const = 0;
+
+        [[nodiscard]] const Capabilities& getCapabilities() const {
+            return m_capabilities;
+        }
+
     protected:
         static inline Renderer* s_ActiveRenderer{};
+
+        Capabilities m_capabilities;
     };
 }
 
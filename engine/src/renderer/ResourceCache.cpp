@@ -0,0 +1,162 @@
+#include "ResourceCache.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+#include "GlRenderer.h"
+#include "core/Hash.h"
+#include "model/MeshCache.h"
+#include "model/Model.h"
+#include "shader/ProgramVariants.h"
+
+Engine::Renderer::ResourceCache& Engine::Renderer::ResourceCache::current() {
+    auto* renderer = Renderer::getActiveRenderer();
+    ASSERT_MSG(renderer != nullptr, "No active renderer to cache resources for.");
+    return static_cast<GlRenderer*>(renderer)->getResourceCache();
+}
+
+const char* Engine::Renderer::ResourceCache::toString(const Type type) {
+    switch (type) {
+        case Type::TEXTURE: return "Textures";
+        case Type::MESH: return "Meshes";
+        case Type::PROGRAM: return "Programs";
+        case Type::COUNT: break;
+    }
+
+    return "unknown";
+}
+
+std::string Engine::Renderer::ResourceCache::normalize(const std::string& path) {
+    std::error_code error;
+    const auto canonical = std::filesystem::weakly_canonical(path, error);
+    if (!error) {
+        return canonical.generic_string();
+    }
+
+    return std::filesystem::path{path}.lexically_normal().generic_string();
+}
+
+Engine::Renderer::Texture Engine::Renderer::ResourceCache::getTexture(const std::string& path, const bool compressed,
+                                                                      const bool async) {
+    Key key{Type::TEXTURE, normalize(path), compressed ? 1u : 0u};
+    if (auto source = find(key)) {
+        return Texture{std::static_pointer_cast<Texture::GlSource>(std::move(source))};
+    }
+
+    const auto& normalizedPath = key.path;
+    auto texture = compressed
+                       ? async ? Texture::loadCompressedAsync(normalizedPath) : Texture::loadCompressed(normalizedPath)
+                       : async ? Texture::loadGlTextureAsync(normalizedPath) : Texture::loadGlTexture(normalizedPath);
+    insert(std::move(key), Entry{texture.m_source});
+    return texture;
+}
+
+std::shared_ptr<Engine::Renderer::Model> Engine::Renderer::ResourceCache::getModel(const std::string& path) {
+    Key key{Type::MESH, normalize(path)};
+    if (auto model = find(key)) {
+        return std::static_pointer_cast<Model>(std::move(model));
+    }
+
+    const auto cookedMesh = MeshCache::loadOrCook(key.path);
+    if (!cookedMesh.isValid()) {
+        LOG_ERR("Mesh not found, from path: " << path << '\n');
+        return nullptr;
+    }
+
+    auto model = std::make_shared<Model>(Model::generate(cookedMesh));
+    insert(std::move(key), Entry{
+               model, cookedMesh.getVertexData().size_bytes() + cookedMesh.getIndexData().size_bytes()
+           });
+    return model;
+}
+
+std::shared_ptr<Engine::Renderer::Shader::ProgramVariants> Engine::Renderer::ResourceCache::getProgramVariants(
+    const std::string& path) {
+    Key key{Type::PROGRAM, normalize(path)};
+    if (auto variants = find(key)) {
+        return std::static_pointer_cast<Shader::ProgramVariants>(std::move(variants));
+    }
+
+    auto variants = std::make_shared<Shader::ProgramVariants>(key.path);
+    insert(std::move(key), Entry{variants});
+    return variants;
+}
+
+void Engine::Renderer::ResourceCache::collect() {
+    m_frame++;
+
+    size_t residentBytes{};
+    std::vector<std::pair<uint64_t, const Key*>> unreferenced; // Last used and key, oldest first once sorted
+    for (auto& [key, entry]: m_entries) {
+        if (entry.resource.use_count() > 1) {
+            entry.lastUsed = m_frame;
+        } else {
+            unreferenced.emplace_back(entry.lastUsed, &key);
+        }
+
+        residentBytes += getByteSize(key, entry);
+    }
+
+    // Programs have no size to count against the budget, only a budget of 0 gets rid of them
+    if (residentBytes > m_budget || m_budget == 0) {
+        std::ranges::sort(unreferenced, {}, &std::pair<uint64_t, const Key*>::first);
+        for (const auto& [lastUsed, key]: unreferenced) {
+            if (m_budget != 0 && residentBytes <= m_budget) {
+                break;
+            }
+
+            const auto it = m_entries.find(*key);
+            residentBytes -= getByteSize(it->first, it->second);
+            m_stats[static_cast<size_t>(it->first.type)].evictions++;
+            m_entries.erase(it);
+        }
+    }
+
+    for (auto& stats: m_stats) {
+        stats.resident = 0;
+        stats.referenced = 0;
+        stats.bytes = 0;
+    }
+
+    for (const auto& [key, entry]: m_entries) {
+        auto& stats = m_stats[static_cast<size_t>(key.type)];
+        stats.resident++;
+        if (entry.resource.use_count() > 1) {
+            stats.referenced++;
+        }
+        stats.bytes += getByteSize(key, entry);
+    }
+}
+
+size_t Engine::Renderer::ResourceCache::KeyHash::operator()(const Key& key) const {
+    return Hash::fnv1a64(key.path, Hash::s_fnvOffset64 ^ Hash::mix64(
+                             static_cast<uint64_t>(key.type) << 32 | key.parameters));
+}
+
+size_t Engine::Renderer::ResourceCache::getByteSize(const Key& key, const Entry& entry) {
+    if (key.type == Type::TEXTURE) {
+        return static_cast<const Texture::GlSource*>(entry.resource.get())->getByteSize();
+    }
+
+    return entry.byteSize;
+}
+
+std::shared_ptr<void> Engine::Renderer::ResourceCache::find(const Key& key) {
+    auto& stats = m_stats[static_cast<size_t>(key.type)];
+    const auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    stats.hits++;
+    it->second.lastUsed = m_frame;
+    return it->second.resource;
+}
+
+void Engine::Renderer::ResourceCache::insert(Key key, Entry entry) {
+    entry.lastUsed = m_frame;
+    m_entries.insert_or_assign(std::move(key), std::move(entry));
+}
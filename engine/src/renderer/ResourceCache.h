@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "Texture.h"
+
+namespace Engine::Renderer {
+    class Model;
+
+    namespace Shader {
+        class ProgramVariants;
+    }
+
+    // Textures, meshes and shader programs shared by everyone loading the same file with the same parameters. Keyed on
+    // the normalized path, so a relative and an absolute path to one file hit the same entry. Entries nobody holds
+    // anymore stay resident for the next scene to pick up, until they go over the memory budget and the least recently
+    // used are dropped. A budget of 0 drops them as soon as their last handle goes away. GL thread only.
+    class ResourceCache {
+    public:
+        static constexpr size_t s_defaultBudget{256 * 1024 * 1024};
+
+        enum class Type : uint8_t {
+            TEXTURE, MESH, PROGRAM, COUNT
+        };
+
+        struct Stats {
+            uint32_t resident{};
+            uint32_t referenced{}; // Held outside the cache
+            size_t bytes{}; // Of resident entries, programs are not counted since GL does not tell their size
+            uint32_t hits{};
+            uint32_t misses{};
+            uint32_t evictions{};
+        };
+
+        // Cache of the active renderer
+        static ResourceCache& current();
+
+        static const char* toString(Type type);
+
+        // Absolute and without "." or ".." parts, the path a resource is known by
+        static std::string normalize(const std::string& path);
+
+        explicit ResourceCache(size_t budget = s_defaultBudget) : m_budget{budget} {
+        }
+
+        ResourceCache(const ResourceCache&) = delete;
+
+        ResourceCache& operator=(const ResourceCache&) = delete;
+
+        ResourceCache(ResourceCache&&) = delete;
+
+        ResourceCache& operator=(ResourceCache&&) = delete;
+
+        // Loaded like the matching Texture::load function on a miss. Async ones may still show the placeholder on a hit.
+        Texture getTexture(const std::string& path, bool compressed = false, bool async = true);
+
+        // From MeshCache, without textures. State set on the model, like its instance buffer, is shared with every
+        // other holder. Null if the mesh could not be loaded.
+        std::shared_ptr<Model> getModel(const std::string& path);
+
+        // Every variant built from the file, so are the uniform values set on them
+        std::shared_ptr<Shader::ProgramVariants> getProgramVariants(const std::string& path);
+
+        // Drops entries nobody holds while over the budget, least recently held first. Once per frame.
+        void collect();
+
+        void setBudget(const size_t budget) {
+            m_budget = budget;
+        }
+
+        [[nodiscard]] size_t getBudget() const {
+            return m_budget;
+        }
+
+        // Resident, referenced and bytes as of the last collect()
+        [[nodiscard]] const Stats& getStats(const Type type) const {
+            return m_stats[static_cast<size_t>(type)];
+        }
+
+    private:
+        // Compared in full, the hash only picks the bucket
+        struct Key {
+            Type type{};
+            std::string path; // Normalized
+            uint64_t parameters{};
+
+            bool operator==(const Key&) const = default;
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const;
+        };
+
+        struct Entry {
+            std::shared_ptr<void> resource; // Referenced while anyone else shares its ownership
+            size_t byteSize{}; // Textures change size once streamed in, theirs is read from the source instead
+            uint64_t lastUsed{}; // Frame it was last held outside the cache
+        };
+
+        [[nodiscard]] static size_t getByteSize(const Key& key, const Entry& entry);
+
+        // Null on a miss, counted either way
+        std::shared_ptr<void> find(const Key& key);
+
+        void insert(Key key, Entry entry);
+
+        std::unordered_map<Key, Entry, KeyHash> m_entries;
+        std::array<Stats, static_cast<size_t>(Type::COUNT)> m_stats{};
+        size_t m_budget;
+        uint64_t m_frame{};
+    };
+}
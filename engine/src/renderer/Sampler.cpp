@@ -0,0 +1,80 @@
+#include "Sampler.h"
+
+#include <algorithm>
+#include <glad/glad.h>
+
+#include "GlState.h"
+#include "Renderer.h"
+
+namespace {
+    GLint toGlMinFilter(const Engine::Renderer::Sampler::Filter filter) {
+        switch (filter) {
+            case Engine::Renderer::Sampler::Filter::NEAREST: return GL_NEAREST;
+            case Engine::Renderer::Sampler::Filter::BILINEAR: return GL_LINEAR_MIPMAP_NEAREST;
+            case Engine::Renderer::Sampler::Filter::TRILINEAR: return GL_LINEAR_MIPMAP_LINEAR;
+        }
+
+        return GL_LINEAR_MIPMAP_LINEAR;
+    }
+
+    GLint toGlWrap(const Engine::Renderer::Sampler::Wrap wrap) {
+        switch (wrap) {
+            case Engine::Renderer::Sampler::Wrap::REPEAT: return GL_REPEAT;
+            case Engine::Renderer::Sampler::Wrap::MIRRORED_REPEAT: return GL_MIRRORED_REPEAT;
+            case Engine::Renderer::Sampler::Wrap::CLAMP_TO_EDGE: return GL_CLAMP_TO_EDGE;
+        }
+
+        return GL_REPEAT;
+    }
+}
+
+Engine::Renderer::Sampler::Sampler() : Sampler{Settings{}} {
+}
+
+Engine::Renderer::Sampler::Sampler(const Settings& settings) {
+    RENDERER_API_CALL(glGenSamplers(1, &m_id));
+    set(settings);
+}
+
+Engine::Renderer::Sampler::~Sampler() {
+    destroy();
+}
+
+void Engine::Renderer::Sampler::destroy() {
+    if (m_id == 0) {
+        return;
+    }
+
+    RENDERER_API_CALL(glDeleteSamplers(1, &m_id));
+    GlState::current().onSamplerDeleted(m_id);
+    m_id = {};
+}
+
+void Engine::Renderer::Sampler::bind(const uint32_t slot) const {
+    GlState::current().bindSampler(slot, m_id);
+}
+
+void Engine::Renderer::Sampler::unbind(const uint32_t slot) {
+    GlState::current().bindSampler(slot, 0);
+}
+
+void Engine::Renderer::Sampler::set(const Settings& settings) {
+    m_settings = settings;
+
+    const GLint magFilter = settings.filter == Filter::NEAREST ? GL_NEAREST : GL_LINEAR;
+    RENDERER_API_CALL(glSamplerParameteri(m_id, GL_TEXTURE_MIN_FILTER, toGlMinFilter(settings.filter)));
+    RENDERER_API_CALL(glSamplerParameteri(m_id, GL_TEXTURE_MAG_FILTER, magFilter));
+    RENDERER_API_CALL(glSamplerParameteri(m_id, GL_TEXTURE_WRAP_S, toGlWrap(settings.wrap)));
+    RENDERER_API_CALL(glSamplerParameteri(m_id, GL_TEXTURE_WRAP_T, toGlWrap(settings.wrap)));
+
+#ifdef GL_EXT_texture_filter_anisotropic
+    const float maxAnisotropy = Renderer::getActiveRenderer()->getCapabilities().maxAnisotropy;
+    if (maxAnisotropy > 1.f) {
+        m_settings.anisotropy = std::clamp(settings.anisotropy, 1.f, maxAnisotropy);
+        RENDERER_API_CALL(glSamplerParameterf(m_id, GL_TEXTURE_MAX_ANISOTROPY_EXT, m_settings.anisotropy));
+        return;
+    }
+#endif
+
+    m_settings.anisotropy = 1.f;
+}
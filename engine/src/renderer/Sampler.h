@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+
+#include "core/Typedef.h"
+
+namespace Engine::Renderer {
+    // How textures are filtered and wrapped, kept apart from the textures so every material can sample the same
+    // texture its own way. Bound to a slot, it overrides the parameters of whatever texture is bound there.
+    class Sampler {
+    public:
+        enum class Filter : uint8_t {
+            NEAREST, // No mips, blocky up close and aliasing from afar
+            BILINEAR, // Nearest mip, seams show where the level changes
+            TRILINEAR // Blends between mips
+        };
+
+        enum class Wrap : uint8_t {
+            REPEAT,
+            MIRRORED_REPEAT,
+            CLAMP_TO_EDGE
+        };
+
+        struct Settings {
+            Filter filter{Filter::TRILINEAR};
+            Wrap wrap{Wrap::REPEAT};
+            float anisotropy{1.f}; // Up to the renderer's maxAnisotropy, 1 turns it off
+
+            bool operator==(const Settings&) const = default;
+        };
+
+        Sampler();
+
+        explicit Sampler(const Settings& settings);
+
+        Sampler(const Sampler&) = delete;
+
+        Sampler& operator=(const Sampler&) = delete;
+
+        Sampler(Sampler&& other) noexcept : m_id{other.m_id}, m_settings{other.m_settings} {
+            other.m_id = {};
+        }
+
+        Sampler& operator=(Sampler&& other) noexcept {
+            if (&other == this) {
+                return *this;
+            }
+
+            destroy();
+            m_id = other.m_id;
+            other.m_id = {};
+            m_settings = other.m_settings;
+            return *this;
+        }
+
+        void destroy();
+
+        ~Sampler();
+
+        void bind(uint32_t slot) const;
+
+        static void unbind(uint32_t slot);
+
+        // Changes the sampler for everything using it
+        void set(const Settings& settings);
+
+        [[nodiscard]] Id getId() const {
+            return m_id;
+        }
+
+        [[nodiscard]] const Settings& getSettings() const {
+            return m_settings;
+        }
+
+    private:
+        Id m_id{};
+        Settings m_settings;
+    };
+}
@@ -1,34 +1,131 @@
 #include "Texture.h"
 
+#include <array>
 #include <glad/glad.h>
 
+#include "GlState.h"
 #include "Renderer.h"
+#include "TextureCache.h"
+#include "TextureLoader.h"
 #include "stb_image.h"
 
 Engine::Renderer::Texture::GlSource::~GlSource() {
     RENDERER_API_CALL(glDeleteTextures(1, &m_id));
+    GlState::current().onTextureDeleted(m_id);
 }
 
-Engine::Renderer::Texture Engine::Renderer::Texture::loadGlTexture(const std::string& path) {
-    stbi_set_flip_vertically_on_load(1);
-    auto source = std::make_shared<GlSource>();
-    int bpp{};
-    void* buffer = stbi_load(path.c_str(), &source->m_size.x, &source->m_size.y, &bpp, 4);
+namespace {
+    // Out of the way of the units materials bind to, so loading never disturbs their bindings
+    constexpr uint32_t s_uploadSlot{Engine::Renderer::GlState::s_textureUnits - 1};
+
+    constexpr std::array<uint8_t, 4> s_placeholderPixel{128, 128, 128, 255};
 
+    // GL_NONE where the driver can not sample the format
+    GLenum toGlCompressedFormat(const Engine::Renderer::BlockCompression::Format format) {
+        using enum Engine::Renderer::BlockCompression::Format;
+        const auto& capabilities = Engine::Renderer::Renderer::getActiveRenderer()->getCapabilities();
+        switch (format) {
+#ifdef GL_EXT_texture_compression_s3tc
+            case BC1: return capabilities.compressionS3tc ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_NONE;
+            case BC3: return capabilities.compressionS3tc ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_NONE;
+#endif
+            case BC4: return GL_COMPRESSED_RED_RGTC1;
+            case BC5: return GL_COMPRESSED_RG_RGTC2;
+#ifdef GL_ARB_texture_compression_bptc
+            case BC7: return capabilities.compressionBptc ? GL_COMPRESSED_RGBA_BPTC_UNORM_ARB : GL_NONE;
+#endif
+            default: return GL_NONE;
+        }
+    }
+}
+
+std::shared_ptr<Engine::Renderer::Texture::GlSource> Engine::Renderer::Texture::createSource() {
+    auto source = std::make_shared<GlSource>();
     RENDERER_API_CALL(glGenTextures(1, &source->m_id));
-    RENDERER_API_CALL(glBindTexture(GL_TEXTURE_2D, source->m_id));
+    GlState::current().bindTexture(s_uploadSlot, GL_TEXTURE_2D, source->m_id);
 
-    RENDERER_API_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-    RENDERER_API_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    // Only used where no Sampler is bound
+    RENDERER_API_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+    RENDERER_API_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
     RENDERER_API_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
     RENDERER_API_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
 
+    upload(*source, glm::ivec2{1}, s_placeholderPixel.data());
+    return source;
+}
+
+void Engine::Renderer::Texture::upload(GlSource& source, const glm::ivec2 size, const void* pixels) {
+    source.m_size = size;
+    GlState::current().bindTexture(s_uploadSlot, GL_TEXTURE_2D, source.m_id);
     RENDERER_API_CALL(
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, source->m_size.x, source->m_size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-            buffer));
-    unbind();
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+
+    // Minified textures would alias and thrash the texture cache without a mip chain
+    if (size.x > 1 || size.y > 1) {
+        RENDERER_API_CALL(glGenerateMipmap(GL_TEXTURE_2D));
+    }
+
+    source.m_byteSize = 0;
+    for (auto mipSize = size;; mipSize = glm::max(mipSize / 2, glm::ivec2{1})) {
+        source.m_byteSize += static_cast<size_t>(mipSize.x) * static_cast<size_t>(mipSize.y) * 4;
+        if (mipSize == glm::ivec2{1}) {
+            break;
+        }
+    }
+}
+
+void Engine::Renderer::Texture::upload(GlSource& source, const CookedTexture& texture) {
+    using BlockCompression::Format;
+    const Format format = texture.getFormat();
+    const GLenum compressedFormat = toGlCompressedFormat(format);
+    const bool decode = format != Format::RGBA8 && compressedFormat == GL_NONE;
+    if (decode && format == Format::BC7) {
+        LOG_ERR("BC7 textures are not supported by the driver\n");
+        return;
+    }
+
+    source.m_size = texture.getSize();
+    source.m_byteSize = 0;
+    GlState::current().bindTexture(s_uploadSlot, GL_TEXTURE_2D, source.m_id);
+
+    const auto& levels = texture.getLevels();
+    for (size_t level{}; level < levels.size(); level++) {
+        const auto size = glm::max(glm::ivec2{source.m_size.x >> level, source.m_size.y >> level}, glm::ivec2{1});
+        const auto glLevel = static_cast<GLint>(level);
+        if (format == Format::RGBA8) {
+            RENDERER_API_CALL(glTexImage2D(GL_TEXTURE_2D, glLevel, GL_RGBA8, size.x, size.y, 0, GL_RGBA,
+                GL_UNSIGNED_BYTE, levels[level].data()));
+            source.m_byteSize += levels[level].size();
+        } else if (decode) {
+            const auto rgba = BlockCompression::decode(format, levels[level], size);
+            RENDERER_API_CALL(glTexImage2D(GL_TEXTURE_2D, glLevel, GL_RGBA8, size.x, size.y, 0, GL_RGBA,
+                GL_UNSIGNED_BYTE, rgba.data()));
+            source.m_byteSize += rgba.size();
+        } else {
+            RENDERER_API_CALL(glCompressedTexImage2D(GL_TEXTURE_2D, glLevel, compressedFormat, size.x, size.y, 0,
+                static_cast<GLsizei>(levels[level].size()), levels[level].data()));
+            source.m_byteSize += levels[level].size();
+        }
+    }
+
+    RENDERER_API_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size() - 1)));
+
+    // Single channel maps are stored as red only, sampled as grey like the image they were cooked from
+    const std::array<GLint, 4> swizzle = format == Format::BC4
+                                             ? std::array<GLint, 4>{GL_RED, GL_RED, GL_RED, GL_ONE}
+                                             : std::array<GLint, 4>{GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA};
+    RENDERER_API_CALL(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle.data()));
+}
+
+Engine::Renderer::Texture Engine::Renderer::Texture::loadGlTexture(const std::string& path) {
+    stbi_set_flip_vertically_on_load(1);
+    auto source = createSource();
+    glm::ivec2 size{};
+    int bpp{};
+    void* buffer = stbi_load(path.c_str(), &size.x, &size.y, &bpp, 4);
 
     if (buffer != nullptr) {
+        upload(*source, size, buffer);
         stbi_image_free(buffer);
     } else {
         LOG_ERR("Texture not found, from path: " << path << '\n');
@@ -37,11 +134,31 @@ Engine::Renderer::Texture Engine::Renderer::Texture::loadGlTexture(const std::st
     return Texture{std::move(source)};
 }
 
+Engine::Renderer::Texture Engine::Renderer::Texture::loadGlTextureAsync(const std::string& path) {
+    return TextureLoader::current().load(path);
+}
+
+Engine::Renderer::Texture Engine::Renderer::Texture::loadCompressed(const std::string& path) {
+    auto source = createSource();
+    const auto cooked = TextureCache::loadOrCook(path);
+
+    if (cooked.isValid()) {
+        upload(*source, cooked);
+    } else {
+        LOG_ERR("Texture not found, from path: " << path << '\n');
+    }
+
+    return Texture{std::move(source)};
+}
+
+Engine::Renderer::Texture Engine::Renderer::Texture::loadCompressedAsync(const std::string& path) {
+    return TextureLoader::current().load(path, true);
+}
+
 void Engine::Renderer::Texture::bind(const uint32_t slot) const {
-    RENDERER_API_CALL(glActiveTexture(GL_TEXTURE0 + slot));
-    RENDERER_API_CALL(glBindTexture(GL_TEXTURE_2D, m_source->m_id));
+    GlState::current().bindTexture(slot, GL_TEXTURE_2D, m_source->m_id);
 }
 
 void Engine::Renderer::Texture::unbind() {
-    RENDERER_API_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+    GlState::current().bindTexture(0, GL_TEXTURE_2D, 0);
 }
@@ -9,6 +9,8 @@
 #include "core/Typedef.h"
 
 namespace Engine::Renderer {
+    class CookedTexture;
+
     class Texture {
     public:
         class GlSource {
@@ -33,15 +35,31 @@ namespace Engine::Renderer {
                 return m_size;
             }
 
+            // Of every level, in the format it was uploaded in
+            [[nodiscard]] size_t getByteSize() const {
+                return m_byteSize;
+            }
+
             friend Texture;
+            friend class TextureLoader;
 
         private:
             Id m_id{};
             glm::ivec2 m_size{};
+            size_t m_byteSize{};
         };
 
         static Texture loadGlTexture(const std::string& path);
 
+        // Returns at once with a placeholder, see TextureLoader
+        static Texture loadGlTextureAsync(const std::string& path);
+
+        // Block compressed with its mip chain, cooked by TextureCache on first use. Decoded to RGBA8 where the driver
+        // can not sample the format.
+        static Texture loadCompressed(const std::string& path);
+
+        static Texture loadCompressedAsync(const std::string& path);
+
         void bind(uint32_t slot = 0) const;
 
         static void unbind();
@@ -51,6 +69,18 @@ namespace Engine::Renderer {
         }
 
     private:
+        friend class ResourceCache;
+        friend class TextureLoader;
+
+        // A new texture holding a single placeholder pixel
+        static std::shared_ptr<GlSource> createSource();
+
+        // Replaces the whole image and its mip chain, pixels are RGBA8
+        static void upload(GlSource& source, glm::ivec2 size, const void* pixels);
+
+        // Replaces the whole image with every level of the cooked one
+        static void upload(GlSource& source, const CookedTexture& texture);
+
         explicit Texture(std::shared_ptr<GlSource> source) : m_source(std::move(source)),
                                                              m_subRect{glm::vec2{}, m_source->getSize()} {
         }
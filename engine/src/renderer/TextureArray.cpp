@@ -0,0 +1,214 @@
+#include "TextureArray.h"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <unordered_map>
+#include <glad/glad.h>
+
+#include "AtlasPacker.h"
+#include "GlState.h"
+#include "Renderer.h"
+#include "TextureLoader.h"
+
+namespace {
+    // Out of the way of the units materials bind to, like texture uploads
+    constexpr uint32_t s_uploadSlot{Engine::Renderer::GlState::s_textureUnits - 1};
+
+    struct Entry {
+        std::vector<const uint8_t*> layers; // Null where the layer stays black
+        glm::ivec2 size{};
+        glm::ivec2 paddedSize{};
+        size_t page{};
+        glm::ivec2 position{};
+        bool placed{};
+    };
+
+    int alignUp(const int value, const int alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Surrounds the image with copies of its edge texels, so filtering near the edge never reaches a neighbour
+    std::vector<uint8_t> padImage(const uint8_t* pixels, const glm::ivec2 size, const int padding) {
+        const glm::ivec2 padded = size + 2 * padding;
+        std::vector<uint8_t> output(static_cast<size_t>(padded.x) * static_cast<size_t>(padded.y) * 4);
+        for (int y{}; y < padded.y; y++) {
+            const int sourceY = std::clamp(y - padding, 0, size.y - 1);
+            for (int x{}; x < padded.x; x++) {
+                const int sourceX = std::clamp(x - padding, 0, size.x - 1);
+                std::copy_n(pixels + (static_cast<size_t>(sourceY) * static_cast<size_t>(size.x) +
+                                      static_cast<size_t>(sourceX)) * 4, 4,
+                            output.begin() + static_cast<ptrdiff_t>(
+                                (static_cast<size_t>(y) * static_cast<size_t>(padded.x) + static_cast<size_t>(x)) *
+                                4));
+            }
+        }
+
+        return output;
+    }
+}
+
+Engine::Renderer::TextureArray::Builder::Builder(const glm::ivec2 layerSize, const uint32_t layersPerEntry,
+                                                 const uint32_t padding) : m_layerSize{layerSize},
+                                                                           m_layersPerEntry{layersPerEntry},
+                                                                           m_padding{padding} {
+    ASSERT(layerSize.x > 0 && layerSize.y > 0 && layersPerEntry > 0);
+}
+
+uint32_t Engine::Renderer::TextureArray::Builder::add(std::vector<std::string> paths) {
+    ASSERT_MSG(paths.size() == m_layersPerEntry, "Entry needs " << m_layersPerEntry << " images, got " << paths.
+        size());
+    m_entries.push_back(std::move(paths));
+    return static_cast<uint32_t>(m_entries.size() - 1);
+}
+
+Engine::Renderer::TextureArray Engine::Renderer::TextureArray::Builder::build() const {
+    const auto padding = static_cast<int>(m_padding);
+
+    // A mip texel covers 2^level texels, past the padding it would blend entries together
+    const int maxLevel = m_padding > 0 ? static_cast<int>(std::bit_width(m_padding)) - 1 : 0;
+    const int alignment = 1 << maxLevel;
+
+    // Decoded all at once on the loader's workers, an image used by several entries only once
+    std::vector<std::string> paths;
+    std::unordered_map<std::string, size_t> pathIndices;
+    for (const auto& entryPaths: m_entries) {
+        for (const auto& path: entryPaths) {
+            if (!path.empty() && pathIndices.try_emplace(path, paths.size()).second) {
+                paths.push_back(path);
+            }
+        }
+    }
+    const auto images = TextureLoader::current().decode(paths);
+
+    std::vector<Entry> entries(m_entries.size());
+    for (size_t i{}; i < m_entries.size(); i++) {
+        auto& entry = entries[i];
+        for (const auto& path: m_entries[i]) {
+            entry.layers.push_back(nullptr);
+            if (path.empty()) {
+                continue;
+            }
+
+            const auto& image = images[pathIndices.at(path)];
+            if (image.pixels == nullptr) {
+                LOG_ERR("Texture not found, from path: " << path << '\n');
+            } else if (entry.size != glm::ivec2{} && image.size != entry.size) {
+                LOG_ERR("Texture array entry images differ in size, left out: " << path << '\n');
+            } else {
+                entry.size = image.size;
+                entry.layers.back() = image.pixels.get();
+            }
+        }
+
+        entry.paddedSize = glm::ivec2{
+            alignUp(entry.size.x + 2 * padding, alignment), alignUp(entry.size.y + 2 * padding, alignment)
+        };
+    }
+
+    // Tallest first, the skyline stays flat that way
+    std::vector<size_t> order(entries.size());
+    std::iota(order.begin(), order.end(), size_t{});
+    std::ranges::stable_sort(order, [&entries](const size_t a, const size_t b) {
+        return entries[a].paddedSize.y > entries[b].paddedSize.y;
+    });
+
+    std::vector<AtlasPacker> pages;
+    for (const size_t index: order) {
+        auto& entry = entries[index];
+        if (entry.size == glm::ivec2{}) {
+            continue;
+        }
+
+        if (entry.paddedSize.x > m_layerSize.x || entry.paddedSize.y > m_layerSize.y) {
+            LOG_ERR("Texture array entry " << index << " does not fit in a layer, left out\n");
+            continue;
+        }
+
+        for (entry.page = 0; !entry.placed; entry.page++) {
+            if (entry.page == pages.size()) {
+                pages.emplace_back(m_layerSize);
+            }
+
+            if (const auto position = pages[entry.page].insert(entry.paddedSize)) {
+                entry.position = *position;
+                entry.placed = true;
+                break;
+            }
+        }
+    }
+
+    TextureArray array;
+    array.m_layerCount = static_cast<uint32_t>(std::max(pages.size(), size_t{1})) * m_layersPerEntry;
+    RENDERER_API_CALL(glGenTextures(1, &array.m_id));
+    GlState::current().bindTexture(s_uploadSlot, GL_TEXTURE_2D_ARRAY, array.m_id);
+    RENDERER_API_CALL(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, m_layerSize.x, m_layerSize.y,
+        static_cast<GLsizei>(array.m_layerCount), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+
+    // Left undefined the space between entries would bleed into the smaller mips
+    const std::vector<uint8_t> clear(static_cast<size_t>(m_layerSize.x) * static_cast<size_t>(m_layerSize.y) * 4);
+    for (uint32_t layer{}; layer < array.m_layerCount; layer++) {
+        RENDERER_API_CALL(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(layer), m_layerSize.x,
+            m_layerSize.y, 1, GL_RGBA, GL_UNSIGNED_BYTE, clear.data()));
+    }
+
+    const glm::vec2 layerSize{m_layerSize};
+    array.m_regions.resize(entries.size());
+    for (size_t i{}; i < entries.size(); i++) {
+        const auto& entry = entries[i];
+        if (!entry.placed) {
+            continue;
+        }
+
+        const auto firstLayer = static_cast<uint32_t>(entry.page) * m_layersPerEntry;
+        for (size_t layer{}; layer < entry.layers.size(); layer++) {
+            if (entry.layers[layer] == nullptr) {
+                continue;
+            }
+
+            const auto padded = padImage(entry.layers[layer], entry.size, padding);
+            RENDERER_API_CALL(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, entry.position.x, entry.position.y,
+                static_cast<GLint>(firstLayer + layer), entry.size.x + 2 * padding, entry.size.y + 2 * padding, 1,
+                GL_RGBA, GL_UNSIGNED_BYTE, padded.data()));
+        }
+
+        array.m_regions[i] = Region{
+            Rect{glm::vec2{entry.position + padding} / layerSize, glm::vec2{entry.size} / layerSize}, firstLayer
+        };
+    }
+
+    RENDERER_API_CALL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+    RENDERER_API_CALL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    RENDERER_API_CALL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    RENDERER_API_CALL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    RENDERER_API_CALL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, maxLevel));
+    RENDERER_API_CALL(glGenerateMipmap(GL_TEXTURE_2D_ARRAY));
+
+    float occupancy{};
+    for (const auto& page: pages) {
+        occupancy += page.getOccupancy();
+    }
+    array.m_occupancy = pages.empty() ? 0.f : occupancy / static_cast<float>(pages.size());
+
+    LOG("Texture array: " << entries.size() << " entries in " << array.m_layerCount << " layers of " <<
+        m_layerSize.x << 'x' << m_layerSize.y << ", " << array.m_occupancy * 100.f << "% used\n");
+    return array;
+}
+
+Engine::Renderer::TextureArray::~TextureArray() {
+    destroy();
+}
+
+void Engine::Renderer::TextureArray::destroy() {
+    if (m_id == 0) {
+        return;
+    }
+
+    RENDERER_API_CALL(glDeleteTextures(1, &m_id));
+    GlState::current().onTextureDeleted(m_id);
+    m_id = {};
+}
+
+void Engine::Renderer::TextureArray::bind(const uint32_t slot) const {
+    GlState::current().bindTexture(slot, GL_TEXTURE_2D_ARRAY, m_id);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include "core/Rect.h"
+#include "core/Typedef.h"
+
+namespace Engine::Renderer {
+    // Many small textures in one GL_TEXTURE_2D_ARRAY, so draws using different ones need no rebinding and can go into
+    // one instanced call. Entries are packed into the layers with AtlasPacker. An entry can span several layers, like
+    // the maps of a material, which then share a rect so one uv transform reaches all of them.
+    class TextureArray {
+    public:
+        // Where an entry ended up. Sample it at vec3(uv * uvRect.size + uvRect.origin, layer + i).
+        struct Region {
+            Rect uvRect{};
+            uint32_t layer{};
+
+            // Origin in xy, size in zw, the form shaders take it in
+            [[nodiscard]] glm::vec4 getUvTransform() const {
+                return uvRect.vec4;
+            }
+        };
+
+        class Builder {
+        public:
+            // Padding is repeated edge texels around every entry, mips stop where it no longer keeps entries apart
+            explicit Builder(glm::ivec2 layerSize, uint32_t layersPerEntry = 1, uint32_t padding = 8);
+
+            // One image per layer of the entry, all the same size. An empty path leaves its layer black. Returns the
+            // index of the entry.
+            uint32_t add(std::vector<std::string> paths);
+
+            // Waits for the images to decode on the TextureLoader workers
+            [[nodiscard]] TextureArray build() const;
+
+        private:
+            glm::ivec2 m_layerSize;
+            uint32_t m_layersPerEntry;
+            uint32_t m_padding;
+            std::vector<std::vector<std::string>> m_entries;
+        };
+
+        TextureArray(const TextureArray&) = delete;
+
+        TextureArray& operator=(const TextureArray&) = delete;
+
+        TextureArray(TextureArray&& other) noexcept : m_id{other.m_id}, m_layerCount{other.m_layerCount},
+                                                      m_regions{std::move(other.m_regions)},
+                                                      m_occupancy{other.m_occupancy} {
+            other.m_id = {};
+        }
+
+        TextureArray& operator=(TextureArray&& other) noexcept {
+            if (&other == this) {
+                return *this;
+            }
+
+            destroy();
+            m_id = other.m_id;
+            other.m_id = {};
+            m_layerCount = other.m_layerCount;
+            m_regions = std::move(other.m_regions);
+            m_occupancy = other.m_occupancy;
+            return *this;
+        }
+
+        void destroy();
+
+        ~TextureArray();
+
+        void bind(uint32_t slot) const;
+
+        [[nodiscard]] const Region& getRegion(const uint32_t entry) const {
+            return m_regions[entry];
+        }
+
+        [[nodiscard]] uint32_t getEntryCount() const {
+            return static_cast<uint32_t>(m_regions.size());
+        }
+
+        [[nodiscard]] uint32_t getLayerCount() const {
+            return m_layerCount;
+        }
+
+        // Of the layers, padding counts as used
+        [[nodiscard]] float getOccupancy() const {
+            return m_occupancy;
+        }
+
+        [[nodiscard]] Id getId() const {
+            return m_id;
+        }
+
+    private:
+        TextureArray() = default;
+
+        Id m_id{};
+        uint32_t m_layerCount{};
+        std::vector<Region> m_regions;
+        float m_occupancy{};
+    };
+}
@@ -0,0 +1,467 @@
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include "core/Hash.h"
+#include "core/Log.h"
+#include "stb_image.h"
+
+namespace {
+    using Engine::Renderer::BlockCompression::Format;
+
+    constexpr std::array<uint8_t, 12> s_identifier{0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+    constexpr std::string_view s_sourceKey{"FPSsource"};
+    constexpr std::string_view s_writerKey{"KTXwriter"};
+    constexpr std::string_view s_writer{"first-person-sus"};
+    constexpr uint32_t s_maxLevels{16};
+
+    struct Header {
+        std::array<uint8_t, 12> identifier;
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+
+    struct LevelIndex {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    // Value of the s_sourceKey entry, what the file was cooked from
+    struct SourceRecord {
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t size;
+        int64_t mtime;
+        uint64_t hash;
+    };
+
+    static_assert(sizeof(Header) == 80 && sizeof(LevelIndex) == 24);
+    static_assert(std::is_trivially_copyable_v<SourceRecord>);
+
+    // One channel of the data format descriptor
+    struct Sample {
+        uint8_t channel;
+        uint16_t bitOffset;
+        uint8_t bitLength; // Minus one
+        uint32_t upper;
+    };
+
+    struct FormatInfo {
+        Format format;
+        uint32_t vkFormat;
+        uint8_t colorModel;
+        uint8_t blockDimension; // Minus one
+        std::array<Sample, 4> samples;
+        uint32_t sampleCount;
+    };
+
+    // Vulkan formats and Khronos data format descriptor models, all UNORM like the RGBA8 textures they replace
+    constexpr std::array<FormatInfo, 6> s_formats{
+        {
+            {Format::RGBA8, 37, 1, 0, {{{0, 0, 7, 255}, {1, 8, 7, 255}, {2, 16, 7, 255}, {15, 24, 7, 255}}}, 4},
+            {Format::BC1, 131, 128, 3, {{{0, 0, 63, 0xFFFFFFFF}}}, 1},
+            {Format::BC3, 137, 130, 3, {{{15, 0, 63, 0xFFFFFFFF}, {0, 64, 63, 0xFFFFFFFF}}}, 2},
+            {Format::BC4, 139, 131, 3, {{{0, 0, 63, 0xFFFFFFFF}}}, 1},
+            {Format::BC5, 141, 132, 3, {{{0, 0, 63, 0xFFFFFFFF}, {1, 64, 63, 0xFFFFFFFF}}}, 2},
+            {Format::BC7, 145, 134, 3, {{{0, 0, 127, 0xFFFFFFFF}}}, 1}
+        }
+    };
+
+    // One per cooked file. TextureLoader workers loading the same texture at once then cook it only once, and never
+    // write or patch the file while another one does.
+    std::mutex s_cookLocksMutex;
+    std::unordered_map<std::string, std::mutex> s_cookLocks;
+
+    std::mutex& getCookLock(const std::string& cookedPath) {
+        const std::scoped_lock lock{s_cookLocksMutex};
+        return s_cookLocks[cookedPath];
+    }
+
+    const FormatInfo* findFormat(const Format format) {
+        const auto it = std::ranges::find(s_formats, format, &FormatInfo::format);
+        return it != s_formats.end() ? &*it : nullptr;
+    }
+
+    const FormatInfo* findVkFormat(const uint32_t vkFormat) {
+        const auto it = std::ranges::find(s_formats, vkFormat, &FormatInfo::vkFormat);
+        return it != s_formats.end() ? &*it : nullptr;
+    }
+
+    size_t alignUp(const size_t value, const size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    glm::ivec2 levelSize(const glm::ivec2 size, const uint32_t level) {
+        return glm::max(glm::ivec2{size.x >> level, size.y >> level}, glm::ivec2{1});
+    }
+
+    // Basic descriptor block, preceded by the total size
+    std::vector<uint32_t> dataFormatDescriptor(const FormatInfo& info) {
+        constexpr uint32_t linearTransfer{1};
+        constexpr uint32_t bt709Primaries{1};
+        const uint32_t blockBytes = 24 + 16 * info.sampleCount;
+        const uint32_t bytesPerBlock = Engine::Renderer::BlockCompression::bytesPerBlock(info.format);
+        const uint32_t bytesPlane0 = info.format == Format::RGBA8 ? 4 : bytesPerBlock;
+
+        std::vector<uint32_t> words{
+            4 + blockBytes,
+            0, // Khronos vendor, basic descriptor type
+            2 | blockBytes << 16, // Version 1.3
+            info.colorModel | bt709Primaries << 8 | linearTransfer << 16,
+            static_cast<uint32_t>(info.blockDimension | info.blockDimension << 8),
+            bytesPlane0,
+            0
+        };
+        for (uint32_t i{}; i < info.sampleCount; i++) {
+            const auto& sample = info.samples[i];
+            words.push_back(sample.bitOffset | static_cast<uint32_t>(sample.bitLength) << 16 |
+                            static_cast<uint32_t>(sample.channel) << 24);
+            words.push_back(0);
+            words.push_back(0);
+            words.push_back(sample.upper);
+        }
+
+        return words;
+    }
+
+    void appendKeyValue(std::vector<uint8_t>& output, const std::string_view key, const void* value,
+                        const size_t size) {
+        const auto length = static_cast<uint32_t>(key.size() + 1 + size);
+        const size_t offset = output.size();
+        output.resize(alignUp(offset + sizeof(length) + length, 4));
+        std::memcpy(output.data() + offset, &length, sizeof(length));
+        std::memcpy(output.data() + offset + sizeof(length), key.data(), key.size());
+        std::memcpy(output.data() + offset + sizeof(length) + key.size() + 1, value, size);
+    }
+
+    // Offset of the s_sourceKey value in keyValues
+    std::optional<size_t> findSourceRecord(const std::span<const uint8_t> keyValues) {
+        size_t offset{};
+        while (offset + sizeof(uint32_t) <= keyValues.size()) {
+            uint32_t length{};
+            std::memcpy(&length, keyValues.data() + offset, sizeof(length));
+            offset += sizeof(length);
+            if (length > keyValues.size() - offset) {
+                return std::nullopt;
+            }
+
+            const auto entry = keyValues.subspan(offset, length);
+            if (entry.size() == s_sourceKey.size() + 1 + sizeof(SourceRecord) &&
+                std::equal(s_sourceKey.begin(), s_sourceKey.end(), entry.begin()) && entry[s_sourceKey.size()] == 0) {
+                return offset + s_sourceKey.size() + 1;
+            }
+
+            offset = alignUp(offset + length, 4);
+        }
+
+        return std::nullopt;
+    }
+
+    struct Parsed {
+        Header header;
+        const FormatInfo* format;
+        std::vector<std::span<const uint8_t>> levels;
+        std::optional<SourceRecord> source;
+        size_t sourceOffset{}; // In the file
+    };
+
+    std::optional<Parsed> parse(const std::span<const uint8_t> bytes) {
+        if (bytes.size() < sizeof(Header)) {
+            return std::nullopt;
+        }
+
+        Parsed parsed{};
+        auto& header = parsed.header;
+        std::memcpy(&header, bytes.data(), sizeof(Header));
+        parsed.format = findVkFormat(header.vkFormat);
+
+        // Only single 2D images, mip chains generated at load time do not work for block compressed formats
+        if (header.identifier != s_identifier || parsed.format == nullptr || header.pixelWidth == 0 ||
+            header.pixelHeight == 0 || header.pixelDepth != 0 || header.layerCount > 1 || header.faceCount != 1 ||
+            header.supercompressionScheme != 0 || header.levelCount == 0 || header.levelCount > s_maxLevels ||
+            sizeof(Header) + header.levelCount * sizeof(LevelIndex) > bytes.size() ||
+            static_cast<uint64_t>(header.kvdByteOffset) + header.kvdByteLength > bytes.size()) {
+            return std::nullopt;
+        }
+
+        const glm::ivec2 size{static_cast<int>(header.pixelWidth), static_cast<int>(header.pixelHeight)};
+        for (uint32_t level{}; level < header.levelCount; level++) {
+            LevelIndex index{};
+            std::memcpy(&index, bytes.data() + sizeof(Header) + level * sizeof(LevelIndex), sizeof(LevelIndex));
+
+            const size_t expected = Engine::Renderer::BlockCompression::levelBytes(parsed.format->format,
+                                                                                   levelSize(size, level));
+            if (index.byteLength != expected || index.byteOffset > bytes.size() ||
+                index.byteLength > bytes.size() - index.byteOffset) {
+                return std::nullopt;
+            }
+
+            parsed.levels.push_back(bytes.subspan(index.byteOffset, index.byteLength));
+        }
+
+        if (const auto offset = findSourceRecord(bytes.subspan(header.kvdByteOffset, header.kvdByteLength))) {
+            parsed.sourceOffset = header.kvdByteOffset + *offset;
+            parsed.source.emplace();
+            std::memcpy(&*parsed.source, bytes.data() + parsed.sourceOffset, sizeof(SourceRecord));
+        }
+
+        return parsed;
+    }
+
+    // 2x2 box filter, odd edges repeat their last texel
+    std::vector<uint8_t> downsample(const std::span<const uint8_t> rgba, const glm::ivec2 size) {
+        const glm::ivec2 next = levelSize(size, 1);
+        std::vector<uint8_t> output(static_cast<size_t>(next.x) * static_cast<size_t>(next.y) * 4);
+        const auto texel = [&](const int x, const int y, const size_t channel) {
+            const size_t offset = static_cast<size_t>(std::min(y, size.y - 1)) * static_cast<size_t>(size.x) +
+                                  static_cast<size_t>(std::min(x, size.x - 1));
+            return static_cast<uint32_t>(rgba[offset * 4 + channel]);
+        };
+
+        for (int y{}; y < next.y; y++) {
+            for (int x{}; x < next.x; x++) {
+                for (size_t channel{}; channel < 4; channel++) {
+                    const uint32_t sum = texel(2 * x, 2 * y, channel) + texel(2 * x + 1, 2 * y, channel) +
+                                         texel(2 * x, 2 * y + 1, channel) + texel(2 * x + 1, 2 * y + 1, channel);
+                    output[(static_cast<size_t>(y) * static_cast<size_t>(next.x) + static_cast<size_t>(x)) * 4 +
+                           channel] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+
+        return output;
+    }
+}
+
+size_t Engine::Renderer::CookedTexture::getByteSize() const {
+    size_t bytes{};
+    for (const auto& level: m_levels) {
+        bytes += level.size();
+    }
+
+    return bytes;
+}
+
+std::string Engine::Renderer::TextureCache::cookedPath(const std::string& sourcePath) {
+    const std::filesystem::path path{sourcePath};
+    const auto normalized = std::filesystem::weakly_canonical(path).generic_string();
+
+    // The path hash keeps equally named textures from different directories apart
+    std::array<char, 17> pathHash{};
+    std::to_chars(pathHash.data(), pathHash.data() + pathHash.size() - 1, Hash::fnv1a64(normalized), 16);
+    return std::string{ENGINE_CACHE_PATH"/"} + path.stem().string() + '-' + pathHash.data() + ".ktx2";
+}
+
+std::vector<uint8_t> Engine::Renderer::TextureCache::cookToMemory(const std::string& sourcePath,
+                                                                  const std::optional<BlockCompression::Format>
+                                                                  format) {
+    const auto sourceInfo = CookedFile::getSourceInfo(sourcePath);
+    const MappedFile source{sourcePath};
+    if (!sourceInfo || !source.isOpen()) {
+        LOG_ERR("Could not cook texture, source is missing: " << sourcePath << '\n');
+        return {};
+    }
+
+    // Flipped like every other texture, may run on a TextureLoader worker
+    stbi_set_flip_vertically_on_load_thread(1);
+    glm::ivec2 size{};
+    int channels{};
+    uint8_t* pixels = stbi_load_from_memory(reinterpret_cast<const uint8_t*>(source.data()),
+                                            static_cast<int>(source.size()), &size.x, &size.y, &channels, 4);
+    if (pixels == nullptr) {
+        LOG_ERR("Could not cook texture, source is not an image: " << sourcePath << '\n');
+        return {};
+    }
+
+    std::vector<uint8_t> level{pixels, pixels + BlockCompression::levelBytes(Format::RGBA8, size)};
+    stbi_image_free(pixels);
+
+    const Format chosen = format.value_or(BlockCompression::choose(level));
+    const auto* info = findFormat(chosen);
+    if (chosen == Format::BC7 || info == nullptr) {
+        LOG_ERR("Could not cook texture, no encoder for " << BlockCompression::toString(chosen) << ": " <<
+            sourcePath << '\n');
+        return {};
+    }
+
+    std::vector<std::vector<uint8_t>> levels;
+    for (glm::ivec2 mipSize = size;; mipSize = levelSize(mipSize, 1)) {
+        levels.push_back(chosen == Format::RGBA8 ? level : BlockCompression::encode(chosen, level, mipSize));
+        if (mipSize == glm::ivec2{1}) {
+            break;
+        }
+
+        level = downsample(level, mipSize);
+    }
+
+    const SourceRecord record{
+        s_version, 0, sourceInfo->size, sourceInfo->mtime, Hash::bytes(source.data(), source.size())
+    };
+    std::vector<uint8_t> keyValues;
+    appendKeyValue(keyValues, s_sourceKey, &record, sizeof(record));
+    appendKeyValue(keyValues, s_writerKey, s_writer.data(), s_writer.size() + 1);
+    const auto descriptor = dataFormatDescriptor(*info);
+
+    Header header{};
+    header.identifier = s_identifier;
+    header.vkFormat = info->vkFormat;
+    header.typeSize = 1;
+    header.pixelWidth = static_cast<uint32_t>(size.x);
+    header.pixelHeight = static_cast<uint32_t>(size.y);
+    header.faceCount = 1;
+    header.levelCount = static_cast<uint32_t>(levels.size());
+    header.dfdByteOffset = static_cast<uint32_t>(sizeof(Header) + levels.size() * sizeof(LevelIndex));
+    header.dfdByteLength = static_cast<uint32_t>(descriptor.size() * sizeof(uint32_t));
+    header.kvdByteOffset = header.dfdByteOffset + header.dfdByteLength;
+    header.kvdByteLength = static_cast<uint32_t>(keyValues.size());
+
+    // KTX2 stores the smallest level first, each aligned to its block size
+    const size_t alignment = chosen == Format::RGBA8 ? 4 : BlockCompression::bytesPerBlock(chosen);
+    std::vector<LevelIndex> indices(levels.size());
+    size_t offset = header.kvdByteOffset + header.kvdByteLength;
+    for (size_t i = levels.size(); i-- > 0;) {
+        offset = alignUp(offset, alignment);
+        indices[i] = LevelIndex{offset, levels[i].size(), levels[i].size()};
+        offset += levels[i].size();
+    }
+
+    std::vector<uint8_t> bytes(offset);
+    std::memcpy(bytes.data(), &header, sizeof(Header));
+    std::memcpy(bytes.data() + sizeof(Header), indices.data(), indices.size() * sizeof(LevelIndex));
+    std::memcpy(bytes.data() + header.dfdByteOffset, descriptor.data(), header.dfdByteLength);
+    std::memcpy(bytes.data() + header.kvdByteOffset, keyValues.data(), keyValues.size());
+    size_t uncompressed{};
+    for (size_t i{}; i < levels.size(); i++) {
+        std::memcpy(bytes.data() + indices[i].byteOffset, levels[i].data(), levels[i].size());
+        uncompressed += BlockCompression::levelBytes(Format::RGBA8, levelSize(size, static_cast<uint32_t>(i)));
+    }
+
+    LOG("Texture " << sourcePath << ": " << BlockCompression::toString(chosen) << ", " << levels.size() <<
+        " levels, " << uncompressed / 1024 << " KiB as RGBA8 -> " << (offset - indices.back().byteOffset) / 1024 <<
+        " KiB\n");
+    return bytes;
+}
+
+bool Engine::Renderer::TextureCache::cook(const std::string& sourcePath, const std::string& cookedPath,
+                                          const std::optional<BlockCompression::Format> format) {
+    const std::scoped_lock lock{getCookLock(cookedPath)};
+    const auto bytes = cookToMemory(sourcePath, format);
+    return !bytes.empty() && store(sourcePath, cookedPath, bytes);
+}
+
+bool Engine::Renderer::TextureCache::store(const std::string& sourcePath, const std::string& cookedPath,
+                                           const std::span<const uint8_t> bytes) {
+    if (!CookedFile::write(cookedPath, bytes)) {
+        return false;
+    }
+
+    LOG("Cooked " << sourcePath << " -> " << cookedPath << '\n');
+    return true;
+}
+
+std::optional<Engine::Renderer::CookedTexture> Engine::Renderer::TextureCache::adopt(CookedTexture texture,
+    const std::span<const uint8_t> bytes) {
+    auto parsed = parse(bytes);
+    if (!parsed) {
+        return std::nullopt;
+    }
+
+    texture.m_format = parsed->format->format;
+    texture.m_size = glm::ivec2{
+        static_cast<int>(parsed->header.pixelWidth), static_cast<int>(parsed->header.pixelHeight)
+    };
+    texture.m_levels = std::move(parsed->levels);
+    return texture;
+}
+
+std::optional<Engine::Renderer::CookedTexture> Engine::Renderer::TextureCache::load(const std::string& cookedPath) {
+    if (!std::filesystem::exists(cookedPath)) {
+        return std::nullopt;
+    }
+
+    CookedTexture texture;
+    texture.m_file = MappedFile{cookedPath};
+    if (!texture.m_file.isOpen()) {
+        return std::nullopt;
+    }
+
+    const std::span bytes{reinterpret_cast<const uint8_t*>(texture.m_file.data()), texture.m_file.size()};
+    return adopt(std::move(texture), bytes);
+}
+
+Engine::Renderer::CookedFile::Freshness Engine::Renderer::TextureCache::checkSource(
+    const std::span<const uint8_t> bytes, const std::string& sourcePath) {
+    const auto parsed = parse(bytes);
+    if (!parsed) {
+        return CookedFile::Freshness::STALE;
+    }
+
+    const auto& record = parsed->source;
+    if (!record || record->version != s_version) {
+        // Without a source there is nothing to rebuild from, so whatever was cooked last is the best we have
+        return CookedFile::getSourceInfo(sourcePath) ? CookedFile::Freshness::STALE : CookedFile::Freshness::FRESH;
+    }
+
+    return CookedFile::check(sourcePath, {record->size, record->mtime}, record->hash);
+}
+
+Engine::Renderer::CookedTexture Engine::Renderer::TextureCache::loadOrCook(const std::string& sourcePath) {
+    const auto path = cookedPath(sourcePath);
+    const std::scoped_lock lock{getCookLock(path)};
+
+    if (auto texture = load(path)) {
+        const std::span bytes{reinterpret_cast<const uint8_t*>(texture->m_file.data()), texture->m_file.size()};
+        const auto freshness = checkSource(bytes, sourcePath);
+        if (freshness == CookedFile::Freshness::TOUCHED) {
+            // Recorded so the next launch does not hash the source again, written with the file unmapped
+            const size_t mtimeOffset = parse(bytes)->sourceOffset + offsetof(SourceRecord, mtime);
+            texture.reset();
+            CookedFile::updateMtime(path, mtimeOffset, sourcePath);
+            texture = load(path);
+        }
+
+        if (texture && freshness != CookedFile::Freshness::STALE) {
+            return std::move(*texture);
+        }
+
+        if (freshness == CookedFile::Freshness::STALE) {
+            LOG("Cooked texture is stale: " << path << '\n');
+        }
+    }
+
+    auto cooked = cookToMemory(sourcePath, std::nullopt);
+    if (!cooked.empty() && store(sourcePath, path, cooked)) {
+        if (auto texture = load(path)) {
+            return std::move(*texture);
+        }
+    }
+
+    // The cache directory is not writable, keep the cooked bytes in memory for this run instead
+    CookedTexture texture;
+    texture.m_ownedData = std::move(cooked);
+    const std::span<const uint8_t> bytes{texture.m_ownedData};
+    auto adopted = adopt(std::move(texture), bytes);
+    return adopted ? std::move(*adopted) : CookedTexture{};
+}
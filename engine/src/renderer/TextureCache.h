@@ -0,0 +1,76 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include <glm/vec2.hpp>
+
+#include "BlockCompression.h"
+#include "CookedFile.h"
+#include "core/MappedFile.h"
+
+namespace Engine::Renderer {
+    // A texture in cooked form, every mip level already in its gpu format
+    class CookedTexture {
+    public:
+        [[nodiscard]] bool isValid() const {
+            return !m_levels.empty();
+        }
+
+        [[nodiscard]] BlockCompression::Format getFormat() const {
+            return m_format;
+        }
+
+        [[nodiscard]] glm::ivec2 getSize() const {
+            return m_size;
+        }
+
+        // Largest first
+        [[nodiscard]] const std::vector<std::span<const uint8_t>>& getLevels() const {
+            return m_levels;
+        }
+
+        [[nodiscard]] size_t getByteSize() const;
+
+    private:
+        friend class TextureCache;
+
+        MappedFile m_file;
+        std::vector<uint8_t> m_ownedData; // Only used if the cooked file could not be written
+        BlockCompression::Format m_format{};
+        glm::ivec2 m_size{};
+        std::vector<std::span<const uint8_t>> m_levels;
+    };
+
+    // Block compressed textures with their full mip chain, cooked from images into KTX2 files. Like MeshCache the
+    // cooked files remember their source and are rebuilt when it changes. Plain KTX2 files without a source load too,
+    // as long as they hold one 2D image in a format from BlockCompression and no supercompression.
+    class TextureCache {
+    public:
+        static constexpr uint32_t s_version{1};
+
+        static std::string cookedPath(const std::string& sourcePath);
+
+        // Picks the format with BlockCompression::choose unless one is given
+        static bool cook(const std::string& sourcePath, const std::string& cookedPath,
+                         std::optional<BlockCompression::Format> format = std::nullopt);
+
+        // Loads a cooked file as is, without looking at its source
+        static std::optional<CookedTexture> load(const std::string& cookedPath);
+
+        // Loads the cooked version of sourcePath, cooking it first if it is missing or stale. Invalid if the source
+        // could not be read either. Calls for the same source from several threads wait for each other.
+        static CookedTexture loadOrCook(const std::string& sourcePath);
+
+    private:
+        static std::vector<uint8_t> cookToMemory(const std::string& sourcePath,
+                                                 std::optional<BlockCompression::Format> format);
+
+        static std::optional<CookedTexture> adopt(CookedTexture texture, std::span<const uint8_t> bytes);
+
+        static bool store(const std::string& sourcePath, const std::string& cookedPath, std::span<const uint8_t> bytes);
+
+        static CookedFile::Freshness checkSource(std::span<const uint8_t> bytes, const std::string& sourcePath);
+    };
+}
@@ -0,0 +1,179 @@
+#include "TextureLoader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <glad/glad.h>
+
+#include "GlRenderer.h"
+#include "GlState.h"
+#include "Renderer.h"
+#include "stb_image.h"
+
+Engine::Renderer::TextureLoader& Engine::Renderer::TextureLoader::current() {
+    auto* renderer = Renderer::getActiveRenderer();
+    ASSERT_MSG(renderer != nullptr, "No active renderer to load textures for.");
+    return static_cast<GlRenderer*>(renderer)->getTextureLoader();
+}
+
+uint32_t Engine::Renderer::TextureLoader::defaultThreadCount() {
+    return std::clamp(std::thread::hardware_concurrency(), 2u, 5u) - 1;
+}
+
+void Engine::Renderer::TextureLoader::PixelDeleter::operator()(uint8_t* pixels) const {
+    stbi_image_free(pixels);
+}
+
+Engine::Renderer::TextureLoader::TextureLoader(const uint32_t threadCount, const size_t frameBudget) :
+    m_frameBudget{frameBudget} {
+    RENDERER_API_CALL(glGenBuffers(1, &m_unpackBuffer));
+
+    for (uint32_t i{}; i < std::max(threadCount, 1u); i++) {
+        m_workers.emplace_back([this](const std::stop_token& stop) {
+            work(stop);
+        });
+    }
+}
+
+Engine::Renderer::TextureLoader::~TextureLoader() {
+    for (auto& worker: m_workers) {
+        worker.request_stop();
+    }
+
+    m_workers.clear();
+
+    RENDERER_API_CALL(glDeleteBuffers(1, &m_unpackBuffer));
+    GlState::current().onBufferDeleted(m_unpackBuffer);
+}
+
+Engine::Renderer::Texture Engine::Renderer::TextureLoader::load(const std::string& path, const bool compressed) {
+    auto source = Texture::createSource();
+    {
+        const std::scoped_lock lock{m_jobMutex};
+        m_jobs.push_back(Job{path, source, compressed});
+    }
+
+    m_jobAdded.notify_one();
+    m_stats.inFlight++;
+    return Texture{std::move(source)};
+}
+
+std::vector<Engine::Renderer::TextureLoader::DecodedImage> Engine::Renderer::TextureLoader::decode(
+    const std::vector<std::string>& paths) {
+    std::vector<DecodedImage> images(paths.size());
+    std::latch done{static_cast<ptrdiff_t>(paths.size())};
+    {
+        const std::scoped_lock lock{m_jobMutex};
+        for (size_t i = paths.size(); i-- > 0;) {
+            m_jobs.push_front(Job{paths[i], {}, false, &images[i], &done});
+        }
+    }
+
+    m_jobAdded.notify_all();
+    done.wait();
+    return images;
+}
+
+void Engine::Renderer::TextureLoader::work(const std::stop_token& stop) {
+    // The global flag would race with loads on the GL thread
+    stbi_set_flip_vertically_on_load_thread(1);
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock{m_jobMutex};
+            if (!m_jobAdded.wait(lock, stop, [this] {
+                return !m_jobs.empty();
+            })) {
+                return;
+            }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        if (job.output != nullptr) {
+            int channels{};
+            job.output->pixels.reset(stbi_load(job.path.c_str(), &job.output->size.x, &job.output->size.y, &channels,
+                                               4));
+            job.done->count_down();
+            continue;
+        }
+
+        Image image{
+            .path = std::move(job.path), .target = std::move(job.target), .size = {}, .pixels = {}, .cooked = {}
+        };
+        if (!image.target.expired() && job.compressed) {
+            image.cooked = TextureCache::loadOrCook(image.path);
+        } else if (!image.target.expired()) {
+            int channels{};
+            image.pixels.reset(stbi_load(image.path.c_str(), &image.size.x, &image.size.y, &channels, 4));
+        }
+
+        m_decoded.push(std::move(image));
+    }
+}
+
+void Engine::Renderer::TextureLoader::update() {
+    m_decoded.popAll([this](Image&& image) {
+        m_pending.push_back(std::move(image));
+    });
+
+    m_stats.uploaded = 0;
+    m_stats.uploadedBytes = 0;
+    while (!m_pending.empty()) {
+        const auto& image = m_pending.front();
+        size_t bytes = image.cooked.getByteSize();
+        if (image.pixels != nullptr) {
+            bytes = static_cast<size_t>(image.size.x * image.size.y) * 4;
+        }
+
+        // An image over the whole budget still goes through, on a frame of its own
+        if (m_stats.uploadedBytes > 0 && m_stats.uploadedBytes + bytes > m_frameBudget) {
+            break;
+        }
+
+        upload(image);
+        m_stats.uploaded++;
+        m_stats.uploadedBytes += bytes;
+        m_stats.inFlight--;
+        m_pending.pop_front();
+    }
+}
+
+void Engine::Renderer::TextureLoader::upload(const Image& image) {
+    const auto source = image.target.lock();
+    if (source == nullptr) {
+        return;
+    }
+
+    if (image.cooked.isValid()) {
+        Texture::upload(*source, image.cooked);
+        return;
+    }
+
+    if (image.pixels == nullptr) {
+        LOG_ERR("Texture not found, from path: " << image.path << '\n');
+        return;
+    }
+
+    const auto size = static_cast<GLsizeiptr>(image.size.x) * image.size.y * 4;
+    auto& state = GlState::current();
+    state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, m_unpackBuffer);
+
+    // Orphaned every time, the driver may still be copying the last image out of it
+    RENDERER_API_CALL(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+    auto* mapped = RENDERER_API_CALL_RETURN(
+        glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    if (mapped != nullptr) {
+        std::memcpy(mapped, image.pixels.get(), static_cast<size_t>(size));
+        RENDERER_API_CALL(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+
+        // With an unpack buffer bound the pointer is an offset into it
+        Texture::upload(*source, image.size, nullptr);
+    } else {
+        LOG_ERR("Could not map the texture upload buffer for: " << image.path << '\n');
+    }
+
+    // Left bound, every later glTexImage2D would read from it
+    state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
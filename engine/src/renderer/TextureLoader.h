@@ -0,0 +1,105 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/vec2.hpp>
+
+#include "Texture.h"
+#include "TextureCache.h"
+#include "core/MpscQueue.h"
+#include "core/Typedef.h"
+
+namespace Engine::Renderer {
+    // Decodes images on worker threads and uploads them on the GL thread through a pixel unpack buffer, no more than a
+    // byte budget per frame. Compressed textures are cooked or loaded from TextureCache on the workers instead.
+    // Textures are handed out at once showing a placeholder pixel, the image replaces it under the same id.
+    class TextureLoader {
+    public:
+        static constexpr size_t s_defaultFrameBudget{8 * 1024 * 1024};
+
+        struct PixelDeleter {
+            void operator()(uint8_t* pixels) const;
+        };
+
+        // RGBA8 and flipped like every texture, no pixels if decoding failed
+        struct DecodedImage {
+            glm::ivec2 size{};
+            std::unique_ptr<uint8_t, PixelDeleter> pixels;
+        };
+
+        struct Stats {
+            uint32_t inFlight{}; // Decoding or waiting for upload
+            uint32_t uploaded{}; // Last frame
+            size_t uploadedBytes{}; // Last frame
+        };
+
+        // Loader of the active renderer
+        static TextureLoader& current();
+
+        // Leaves a core to the GL thread
+        static uint32_t defaultThreadCount();
+
+        explicit TextureLoader(uint32_t threadCount = defaultThreadCount(), size_t frameBudget = s_defaultFrameBudget);
+
+        TextureLoader(const TextureLoader&) = delete;
+
+        TextureLoader& operator=(const TextureLoader&) = delete;
+
+        TextureLoader(TextureLoader&&) = delete;
+
+        TextureLoader& operator=(TextureLoader&&) = delete;
+
+        ~TextureLoader();
+
+        Texture load(const std::string& path, bool compressed = false);
+
+        // For callers that need the pixels rather than a texture. Decoded on the workers ahead of queued loads, blocks
+        // until all of them are done.
+        std::vector<DecodedImage> decode(const std::vector<std::string>& paths);
+
+        // GL thread, once per frame. Uploads decoded images in the order they were decoded until the budget is spent.
+        void update();
+
+        [[nodiscard]] const Stats& getStats() const {
+            return m_stats;
+        }
+
+    private:
+        struct Job {
+            std::string path;
+            std::weak_ptr<Texture::GlSource> target;
+            bool compressed{};
+            DecodedImage* output{}; // Set by decode() instead of a target, counted down on done once written
+            std::latch* done{};
+        };
+
+        struct Image {
+            std::string path;
+            std::weak_ptr<Texture::GlSource> target; // Expired if every texture using it went away meanwhile
+            glm::ivec2 size{};
+            std::unique_ptr<uint8_t, PixelDeleter> pixels; // RGBA8, none if decoding failed
+            CookedTexture cooked; // Instead of pixels for compressed textures
+        };
+
+        void work(const std::stop_token& stop);
+
+        void upload(const Image& image);
+
+        std::mutex m_jobMutex;
+        std::condition_variable_any m_jobAdded;
+        std::deque<Job> m_jobs;
+        MpscQueue<Image> m_decoded;
+        std::deque<Image> m_pending; // Decoded, waiting for budget
+        Id m_unpackBuffer{};
+        size_t m_frameBudget;
+        Stats m_stats;
+        std::vector<std::jthread> m_workers; // Last, so they stop and join before anything they use goes away
+    };
+}
@@ -1,8 +1,10 @@
 #include "VertexArray.h"
 
+#include <cstring>
 #include <numeric>
 #include <glad/glad.h>
 
+#include "GlState.h"
 #include "Renderer.h"
 #include "buffer/Vertex.h"
 #include "shader/Source.h"
@@ -15,7 +17,8 @@ Engine::Renderer::VertexArray Engine::Renderer::VertexArray::withGeneratedDefaul
 }
 
 Engine::Renderer::VertexArray::VertexArray(Buffer::Vertex vertexBuffer,
-                                           const Buffer::IndexData& indexData) : m_vertexBuffer{
+                                           const std::span<const Buffer::IndexData::value_type> indexData) :
+    m_vertexBuffer{
         std::move(vertexBuffer)
     },
     m_indexBuffer{
@@ -29,52 +32,80 @@ Engine::Renderer::VertexArray::VertexArray(Buffer::Vertex vertexBuffer,
 
 Engine::Renderer::VertexArray::~VertexArray() {
     RENDERER_API_CALL(glDeleteVertexArrays(1, &m_id));
+    GlState::current().onVertexArrayDeleted(m_id);
 }
 
-void Engine::Renderer::VertexArray::setInstanceBuffer(Buffer::Vertex instanceBuffer) {
+void Engine::Renderer::VertexArray::setInstanceBuffer(Buffer::Stream instanceBuffer, const uint32_t divisor) {
     m_instanceBuffer = std::move(instanceBuffer);
-    const uint32_t attributeStart{static_cast<uint32_t>(m_vertexBuffer.getLayout().getAttributes().size())};
-    attachInstanceBuffer(attributeStart);
+    m_instanceOffset = 0;
+    m_instanceDivisor = divisor;
+    attachInstanceBuffer(getInstanceAttributeStart());
 }
 
-void Engine::Renderer::VertexArray::updateInstanceBuffer(const void* data, uint32_t const count) const {
-    m_instanceBuffer->update(data, count);
+void Engine::Renderer::VertexArray::updateInstanceBuffer(const void* data, uint32_t const count) {
+    const auto instances = mapInstances(count);
+    std::memcpy(instances.data(), data, instances.size());
+    commitInstances();
 }
 
-void Engine::Renderer::VertexArray::attachIndexBuffer(const Buffer::IndexData& indexData) const {
+std::span<uint8_t> Engine::Renderer::VertexArray::mapInstances(const uint32_t count) {
+    ASSERT_MSG(isInstantiable(), "No instance buffer is set.");
+    return m_instanceBuffer->allocate(count);
+}
+
+void Engine::Renderer::VertexArray::commitInstances() {
+    ASSERT_MSG(isInstantiable(), "No instance buffer is set.");
+    m_instanceOffset = m_instanceBuffer->commit();
+    attachInstanceBuffer(getInstanceAttributeStart(), m_instanceOffset);
+}
+
+void Engine::Renderer::VertexArray::setInstanceBase(const uint32_t firstInstance) const {
+    ASSERT_MSG(isInstantiable(), "No instance buffer is set.");
+    attachInstanceBuffer(getInstanceAttributeStart(),
+                         m_instanceOffset + firstInstance * m_instanceBuffer->getLayout().getStride());
+}
+
+void Engine::Renderer::VertexArray::attachIndexBuffer(
+    const std::span<const Buffer::IndexData::value_type> indexData) const {
     bind();
-    RENDERER_API_CALL(
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexData.size() * sizeof(Buffer::IndexData::value_type), indexData.data()
-            , GL_STATIC_DRAW
-        ));
+    m_indexBuffer.bind();
+    RENDERER_API_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexData.size_bytes(), indexData.data(), GL_STATIC_DRAW));
 }
 
 namespace {
     using Engine::Renderer::Renderer;
 
-    // Template based on if we are passing an instance buffer or vertex buffer, both buffers sadly and gladly have the same type
-    template<bool Instanced>
-    void defineBufferAttributes(const Engine::Renderer::Buffer::Vertex& buffer, const uint32_t attributeStart) {
-        const auto& vertexLayout = buffer.getLayout();
-        const auto& elements = vertexLayout.getAttributes();
-        size_t attributeIndex{attributeStart};
-        size_t attributeOffset{};
-        for (const auto& [type, normalized]: elements) {
-            RENDERER_API_CALL(glEnableVertexAttribArray(attributeIndex));
-            RENDERER_API_CALL(
-                glVertexAttribPointer(attributeIndex, Engine::Renderer::Shader::componentCount(type), Engine::Renderer::
-                    Shader::toGlDataType(type),
-                    normalized, vertexLayout.getStride(),
-                    reinterpret_cast<const void*>(
-                        attributeOffset)
-                ));
-
-            if constexpr (Instanced) {
-                RENDERER_API_CALL(glVertexAttribDivisor(attributeIndex, 1));
+    // Vertex and instance buffers both describe their data with a Layout, instance attributes get a divisor.
+    // Matrices take one attribute location per column, integers that are not normalized stay integers.
+    void defineBufferAttributes(const Engine::Renderer::Buffer::Vertex::Layout& vertexLayout,
+                                const uint32_t attributeStart, const size_t baseOffset = 0,
+                                const uint32_t divisor = 0) {
+        namespace Shader = Engine::Renderer::Shader;
+
+        const auto stride = static_cast<GLsizei>(vertexLayout.getStride());
+        GLuint attributeIndex{attributeStart};
+        size_t attributeOffset{baseOffset};
+        for (const auto& [type, normalized]: vertexLayout.getAttributes()) {
+            const uint32_t slots = Shader::slotCount(type);
+            const auto components = static_cast<GLint>(Shader::componentCount(type) / slots);
+            const size_t slotSize = Shader::dataTypeSize(type) / slots;
+            const GLenum glType = Shader::toGlDataType(type);
+            const bool integer = Shader::isIntegerDataType(type) && !normalized;
+
+            for (uint32_t slot{}; slot < slots; slot++) {
+                const auto* offset = reinterpret_cast<const void*>(attributeOffset);
+                RENDERER_API_CALL(glEnableVertexAttribArray(attributeIndex));
+                if (integer) {
+                    RENDERER_API_CALL(glVertexAttribIPointer(attributeIndex, components, glType, stride, offset));
+                } else {
+                    RENDERER_API_CALL(
+                        glVertexAttribPointer(attributeIndex, components, glType, normalized, stride, offset));
+                }
+                RENDERER_API_CALL(glVertexAttribDivisor(attributeIndex, divisor));
+
+                attributeIndex++;
+                attributeOffset += slotSize;
             }
-
-            attributeIndex++;
-            attributeOffset += Engine::Renderer::Shader::dataTypeSize(type);
         }
     }
 }
@@ -82,23 +113,20 @@ namespace {
 void Engine::Renderer::VertexArray::attachVertexBuffer(const uint32_t attributeStart) const {
     bind();
     m_vertexBuffer.bind();
-    defineBufferAttributes<false>(m_vertexBuffer, attributeStart);
+    defineBufferAttributes(m_vertexBuffer.getLayout(), attributeStart);
 }
 
-void Engine::Renderer::VertexArray::attachInstanceBuffer(const uint32_t attributeStart) const {
+void Engine::Renderer::VertexArray::attachInstanceBuffer(const uint32_t attributeStart, const size_t baseOffset) const {
     bind();
     m_instanceBuffer->bind();
-    defineBufferAttributes<true>(*m_instanceBuffer, attributeStart);
+    defineBufferAttributes(m_instanceBuffer->getLayout(), attributeStart, baseOffset, m_instanceDivisor);
 }
 
 void Engine::Renderer::VertexArray::bind() const {
-    RENDERER_API_CALL(glBindVertexArray(m_id));
-    m_indexBuffer.bind();
-    if (m_instanceBuffer.has_value()) {
-        m_instanceBuffer->bind();
-    }
+    // The vertex array remembers its index buffer and attribute sources, nothing else needs binding
+    GlState::current().bindVertexArray(m_id);
 }
 
 void Engine::Renderer::VertexArray::unbind() {
-    RENDERER_API_CALL(glBindVertexArray(0));
+    GlState::current().bindVertexArray(0);
 }
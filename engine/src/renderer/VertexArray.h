@@ -1,5 +1,8 @@
 #pragma once
 
+#include <span>
+
+#include "buffer/Stream.h"
 #include "buffer/Vertex.h"
 #include "core/Typedef.h"
 #include "buffer/Index.h"
@@ -15,13 +18,16 @@ namespace Engine::Renderer {
 
         static VertexArray withGeneratedDefaultIndices(Buffer::Vertex vertexBuffer, uint32_t indexCount);
 
-        VertexArray(Buffer::Vertex vertexBuffer, const Buffer::IndexData& indexData);
+        VertexArray(Buffer::Vertex vertexBuffer, std::span<const Buffer::IndexData::value_type> indexData);
 
         VertexArray(const VertexArray&) = delete;
 
         VertexArray& operator=(const VertexArray&) = delete;
 
         VertexArray(VertexArray&& other) noexcept : m_vertexBuffer{std::move(other.m_vertexBuffer)},
+                                                    m_instanceBuffer{std::move(other.m_instanceBuffer)},
+                                                    m_instanceOffset{other.m_instanceOffset},
+                                                    m_instanceDivisor{other.m_instanceDivisor},
                                                     m_indexBuffer{std::move(other.m_indexBuffer)}, m_id{other.m_id} {
             other.m_id = {};
         }
@@ -32,6 +38,9 @@ namespace Engine::Renderer {
             }
 
             m_vertexBuffer = std::move(other.m_vertexBuffer);
+            m_instanceBuffer = std::move(other.m_instanceBuffer);
+            m_instanceOffset = other.m_instanceOffset;
+            m_instanceDivisor = other.m_instanceDivisor;
             m_indexBuffer = std::move(other.m_indexBuffer);
             m_id = other.m_id;
             other.m_id = {};
@@ -44,27 +53,53 @@ namespace Engine::Renderer {
 
         static void unbind();
 
+        [[nodiscard]] Id getId() const {
+            return m_id;
+        }
+
         [[nodiscard]] const Buffer::Index& getIndexBuffer() const {
             return m_indexBuffer;
         }
 
-        void setInstanceBuffer(Buffer::Vertex instanceBuffer);
+        // divisor is how many instances advance the buffer by one element
+        void setInstanceBuffer(Buffer::Stream instanceBuffer, uint32_t divisor = 1);
+
+        // Copies count instances into the instance stream and commits them
+        void updateInstanceBuffer(const void* data, uint32_t count);
+
+        // Room for count instances to be written in place, call commitInstances() once they are written
+        [[nodiscard]] std::span<uint8_t> mapInstances(uint32_t count);
 
-        void updateInstanceBuffer(const void* data, uint32_t count) const;
+        // Points the instance attributes at the instances written since mapInstances()
+        void commitInstances();
+
+        // Points the instance attributes at firstInstance of the last commit, so instanced draws can start partway
+        // into it without GL 4.2 base instances
+        void setInstanceBase(uint32_t firstInstance) const;
 
         [[nodiscard]] bool isInstantiable() const {
             return m_instanceBuffer.has_value();
         }
 
+        [[nodiscard]] const Buffer::Stream& getInstanceBuffer() const {
+            return *m_instanceBuffer;
+        }
+
     private:
-        void attachIndexBuffer(const Buffer::IndexData& indexData) const;
+        void attachIndexBuffer(std::span<const Buffer::IndexData::value_type> indexData) const;
 
         void attachVertexBuffer(uint32_t attributeStart = 0) const;
 
-        void attachInstanceBuffer(uint32_t attributeStart) const;
+        void attachInstanceBuffer(uint32_t attributeStart, size_t baseOffset = 0) const;
+
+        [[nodiscard]] uint32_t getInstanceAttributeStart() const {
+            return m_vertexBuffer.getLayout().getSlotCount();
+        }
 
         Buffer::Vertex m_vertexBuffer;
-        std::optional<Buffer::Vertex> m_instanceBuffer; // Specifies per-instance attributes
+        std::optional<Buffer::Stream> m_instanceBuffer; // Specifies per-instance attributes
+        size_t m_instanceOffset{}; // Where the last committed instances start in the instance buffer
+        uint32_t m_instanceDivisor{1};
         Buffer::Index m_indexBuffer;
         Id m_id{};
     };
@@ -2,6 +2,7 @@
 
 #include <glad/glad.h>
 
+#include "renderer/GlState.h"
 #include "renderer/Renderer.h"
 
 Engine::Renderer::Buffer::Index::Index(const uint32_t count) : m_count{count} {
@@ -10,6 +11,7 @@ Engine::Renderer::Buffer::Index::Index(const uint32_t count) : m_count{count} {
 
 void Engine::Renderer::Buffer::Index::destroy() {
     RENDERER_API_CALL(glDeleteBuffers(1, &m_id));
+    GlState::current().onBufferDeleted(m_id);
     m_id = {};
 }
 
@@ -18,9 +20,9 @@ Engine::Renderer::Buffer::Index::~Index() {
 }
 
 void Engine::Renderer::Buffer::Index::bind() const {
-    RENDERER_API_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id));
+    GlState::current().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
 }
 
 void Engine::Renderer::Buffer::Index::unbind() {
-    RENDERER_API_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+    GlState::current().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
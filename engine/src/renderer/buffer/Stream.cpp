@@ -0,0 +1,135 @@
+#include "Stream.h"
+
+#include <glad/glad.h>
+
+#include "core/Log.h"
+#include "renderer/GlState.h"
+#include "renderer/Renderer.h"
+
+namespace {
+    constexpr GLuint64 s_fenceTimeout{1'000'000}; // 1ms, in nanoseconds
+}
+
+Engine::Renderer::Buffer::Stream::Stream(Vertex::Layout layout, const uint32_t capacity) : m_layout{std::move(layout)},
+    m_regionSize{capacity * m_layout.getStride()} {
+    ASSERT_MSG(m_regionSize > 0, "Stream needs room for at least one element");
+    RENDERER_API_CALL(glGenBuffers(1, &m_id));
+    bind();
+
+    const auto size = static_cast<GLsizeiptr>(m_regionSize * s_regionCount);
+
+#ifdef GL_ARB_buffer_storage
+    if (Renderer::getActiveRenderer()->getCapabilities().bufferStorage) {
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        RENDERER_API_CALL(glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags));
+        m_mapped = static_cast<uint8_t*>(RENDERER_API_CALL_RETURN(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags)));
+        return;
+    }
+#endif
+
+    RENDERER_API_CALL(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW));
+}
+
+Engine::Renderer::Buffer::Stream::~Stream() {
+    destroy();
+}
+
+void Engine::Renderer::Buffer::Stream::destroy() {
+    for (auto& fence: m_fences) {
+        if (fence != nullptr) {
+            RENDERER_API_CALL(glDeleteSync(static_cast<GLsync>(fence)));
+            fence = nullptr;
+        }
+    }
+
+    // Deleting the buffer also unmaps it
+    RENDERER_API_CALL(glDeleteBuffers(1, &m_id));
+    GlState::current().onBufferDeleted(m_id);
+    m_mapped = nullptr;
+    m_id = {};
+}
+
+void Engine::Renderer::Buffer::Stream::bind() const {
+    GlState::current().bindBuffer(GL_ARRAY_BUFFER, m_id);
+}
+
+std::span<uint8_t> Engine::Renderer::Buffer::Stream::allocate(const uint32_t count) {
+    ASSERT_MSG(m_allocation == 0, "Last stream allocation was not committed");
+    const size_t size = count * m_layout.getStride();
+    ASSERT_MSG(size <= m_regionSize, "Allocation does not fit into a stream region");
+
+    if (size == 0) {
+        return {};
+    }
+
+    if (m_head + size > m_regionSize) {
+        nextRegion();
+    }
+
+    m_allocation = size;
+    const size_t offset = m_region * m_regionSize + m_head;
+    if (m_mapped != nullptr) {
+        return {m_mapped + offset, size};
+    }
+
+    // Nothing the gpu may still read lies in this range, so there is no need to synchronize
+    constexpr GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+    bind();
+    auto* data = static_cast<uint8_t*>(RENDERER_API_CALL_RETURN(
+        glMapBufferRange(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), access)));
+    return {data, size};
+}
+
+size_t Engine::Renderer::Buffer::Stream::commit() {
+    const size_t offset = m_region * m_regionSize + m_head;
+    if (m_mapped == nullptr && m_allocation > 0) {
+        bind();
+        RENDERER_API_CALL(glUnmapBuffer(GL_ARRAY_BUFFER));
+    }
+
+    m_head += m_allocation;
+    m_allocation = 0;
+    return offset;
+}
+
+void Engine::Renderer::Buffer::Stream::nextRegion() {
+    m_head = 0;
+
+    if (m_mapped == nullptr) {
+        m_region = (m_region + 1) % s_regionCount;
+        if (m_region == 0) {
+            // Orphan the storage, the driver hands out a fresh one while the gpu finishes reading the old one
+            bind();
+            RENDERER_API_CALL(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_regionSize * s_regionCount),
+                nullptr, GL_STREAM_DRAW));
+        }
+
+        return;
+    }
+
+    // Every draw reading the region we leave has been issued by now
+    m_fences[m_region] = RENDERER_API_CALL_RETURN(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    m_region = (m_region + 1) % s_regionCount;
+
+    auto& fence = m_fences[m_region];
+    if (fence == nullptr) {
+        return;
+    }
+
+    const auto sync = static_cast<GLsync>(fence);
+    while (true) {
+        const GLenum result = RENDERER_API_CALL_RETURN(
+            glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, s_fenceTimeout));
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+            break;
+        }
+
+        if (result == GL_WAIT_FAILED) {
+            LOG_ERR("Waiting for stream region " << m_region << " failed\n");
+            break;
+        }
+    }
+
+    RENDERER_API_CALL(glDeleteSync(sync));
+    fence = nullptr;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <span>
+
+#include "Vertex.h"
+#include "core/Typedef.h"
+
+namespace Engine::Renderer {
+    class Renderer;
+}
+
+namespace Engine::Renderer::Buffer {
+    // Vertex buffer for data rewritten every frame, split into s_regionCount regions the cpu writes round robin.
+    // With ARB_buffer_storage the buffer stays mapped and every region is fenced, so the cpu only waits if it gets a
+    // whole ring ahead of the gpu. Otherwise every allocation is mapped unsynchronized and the buffer is orphaned when
+    // the ring wraps around.
+    class Stream {
+    public:
+        static constexpr uint32_t s_regionCount{3};
+
+        Stream() = delete;
+
+        // capacity is the most elements a single region, and so a single allocation, can hold
+        Stream(Vertex::Layout layout, uint32_t capacity);
+
+        Stream(const Stream&) = delete;
+
+        Stream& operator=(const Stream&) = delete;
+
+        Stream(Stream&& other) noexcept : m_layout{std::move(other.m_layout)}, m_fences{other.m_fences},
+                                          m_mapped{other.m_mapped}, m_regionSize{other.m_regionSize},
+                                          m_region{other.m_region}, m_head{other.m_head},
+                                          m_allocation{other.m_allocation}, m_id{other.m_id} {
+            other.m_fences = {};
+            other.m_mapped = {};
+            other.m_id = {};
+        }
+
+        Stream& operator=(Stream&& other) noexcept {
+            if (&other == this) {
+                return *this;
+            }
+
+            destroy();
+            m_layout = std::move(other.m_layout);
+            m_fences = other.m_fences;
+            m_mapped = other.m_mapped;
+            m_regionSize = other.m_regionSize;
+            m_region = other.m_region;
+            m_head = other.m_head;
+            m_allocation = other.m_allocation;
+            m_id = other.m_id;
+            other.m_fences = {};
+            other.m_mapped = {};
+            other.m_id = {};
+            return *this;
+        }
+
+        ~Stream();
+
+        void bind() const;
+
+        // Writable memory for count elements. Fill it and commit() it before drawing from it.
+        [[nodiscard]] std::span<uint8_t> allocate(uint32_t count);
+
+        // Makes the last allocation visible to the gpu, returns its offset into the buffer in bytes
+        size_t commit();
+
+        [[nodiscard]] const Vertex::Layout& getLayout() const {
+            return m_layout;
+        }
+
+        [[nodiscard]] uint32_t getCapacity() const {
+            return static_cast<uint32_t>(m_regionSize / m_layout.getStride());
+        }
+
+        [[nodiscard]] bool isPersistent() const {
+            return m_mapped != nullptr;
+        }
+
+    private:
+        void destroy();
+
+        // Fences the current region and moves on to the next one, waiting for the gpu to be done with it
+        void nextRegion();
+
+        Vertex::Layout m_layout;
+        std::array<void*, s_regionCount> m_fences{}; // GLsync, one per region still read by the gpu
+        uint8_t* m_mapped{}; // Whole buffer when persistently mapped
+        size_t m_regionSize{};
+        uint32_t m_region{};
+        size_t m_head{}; // Write offset into the current region
+        size_t m_allocation{}; // Size of the allocation not committed yet
+        Id m_id{};
+    };
+}
@@ -0,0 +1,34 @@
+#include "Uniform.h"
+
+#include <glad/glad.h>
+
+#include "renderer/GlState.h"
+#include "renderer/Renderer.h"
+
+Engine::Renderer::Buffer::Uniform::Uniform(const uint32_t size, const uint32_t binding) : m_size{size},
+    m_binding{binding} {
+    RENDERER_API_CALL(glGenBuffers(1, &m_id));
+    bind();
+    RENDERER_API_CALL(glBufferData(GL_UNIFORM_BUFFER, m_size, nullptr, GL_STREAM_DRAW));
+    GlState::current().bindBufferBase(GL_UNIFORM_BUFFER, m_binding, m_id);
+}
+
+void Engine::Renderer::Buffer::Uniform::destroy() {
+    RENDERER_API_CALL(glDeleteBuffers(1, &m_id));
+    GlState::current().onBufferDeleted(m_id);
+    m_id = {};
+}
+
+Engine::Renderer::Buffer::Uniform::~Uniform() {
+    destroy();
+}
+
+void Engine::Renderer::Buffer::Uniform::bind() const {
+    GlState::current().bindBuffer(GL_UNIFORM_BUFFER, m_id);
+}
+
+void Engine::Renderer::Buffer::Uniform::update(const void* data, const uint32_t size) const {
+    ASSERT_MSG(size == m_size, "Uniform buffer updates replace the whole block");
+    bind();
+    RENDERER_API_CALL(glBufferData(GL_UNIFORM_BUFFER, m_size, data, GL_STREAM_DRAW));
+}
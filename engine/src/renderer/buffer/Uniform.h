@@ -0,0 +1,70 @@
+#pragma once
+
+#include "core/Typedef.h"
+
+namespace Engine::Renderer {
+    class Renderer;
+}
+
+namespace Engine::Renderer::Buffer {
+    // Uniform buffer attached to a fixed binding point for its whole life, programs read from it through their
+    // uniform blocks
+    class Uniform {
+    public:
+        Uniform() = delete;
+
+        Uniform(uint32_t size, uint32_t binding);
+
+        Uniform(const Uniform&) = delete;
+
+        Uniform& operator=(const Uniform&) = delete;
+
+        Uniform(Uniform&& other) noexcept : m_id{other.m_id}, m_size{other.m_size}, m_binding{other.m_binding} {
+            other.m_id = {};
+        }
+
+        Uniform& operator=(Uniform&& other) noexcept {
+            if (&other == this) {
+                return *this;
+            }
+
+            destroy();
+            m_id = other.m_id;
+            other.m_id = {};
+            m_size = other.m_size;
+            m_binding = other.m_binding;
+            return *this;
+        }
+
+        void destroy();
+
+        ~Uniform();
+
+        void bind() const;
+
+        // Replaces the whole buffer, the old storage is orphaned so draws still reading it do not stall the upload
+        void update(const void* data, uint32_t size) const;
+
+        template<typename T>
+        void update(const T& block) const {
+            update(&block, sizeof(T));
+        }
+
+        [[nodiscard]] Id getId() const {
+            return m_id;
+        }
+
+        [[nodiscard]] uint32_t getSize() const {
+            return m_size;
+        }
+
+        [[nodiscard]] uint32_t getBinding() const {
+            return m_binding;
+        }
+
+    private:
+        Id m_id{};
+        uint32_t m_size{};
+        uint32_t m_binding{};
+    };
+}
@@ -2,19 +2,91 @@
 
 #include <glad/glad.h>
 
+#include <array>
+#include <cstring>
 #include <utility>
 
+#include "renderer/GlState.h"
 #include "renderer/Renderer.h"
 
+namespace {
+    using Engine::Renderer::Buffer::BufferData;
+    using Engine::Renderer::Buffer::Vertex;
+
+    // Attribute sizes known at compile time, so every copy becomes a fixed size move the compiler can vectorize.
+    // Layouts are matched by attribute size only, interleaving does not care about the type.
+    template<size_t... Sizes>
+    class FixedLayout {
+    public:
+        static bool matches(const Vertex::Layout& layout) {
+            const auto& attributes = layout.getAttributes();
+            if (attributes.size() != s_sizes.size()) {
+                return false;
+            }
+
+            for (size_t j{}; j < attributes.size(); j++) {
+                if (Engine::Renderer::Shader::dataTypeSize(attributes[j].dataType) != s_sizes[j]) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static void interleave(const std::vector<BufferData>& dataBatch, uint8_t* destination, const size_t count) {
+            interleave(dataBatch, destination, count, std::make_index_sequence<sizeof...(Sizes)>{});
+        }
+
+        static void deinterleave(const uint8_t* source, std::vector<BufferData>& dataBatch, const size_t count) {
+            deinterleave(source, dataBatch, count, std::make_index_sequence<sizeof...(Sizes)>{});
+        }
+
+    private:
+        static constexpr std::array<size_t, sizeof...(Sizes)> s_sizes{Sizes...};
+        static constexpr size_t s_stride{(Sizes + ...)};
+        static constexpr auto s_offsets = [] {
+            std::array<size_t, sizeof...(Sizes)> offsets{};
+            for (size_t j{1}; j < offsets.size(); j++) {
+                offsets[j] = offsets[j - 1] + s_sizes[j - 1];
+            }
+            return offsets;
+        }();
+
+        template<size_t... J>
+        static void interleave(const std::vector<BufferData>& dataBatch, uint8_t* destination, const size_t count,
+                               std::index_sequence<J...> /*unused*/) {
+            const std::array<const uint8_t*, sizeof...(J)> sources{dataBatch[J].data()...};
+            for (size_t i{}; i < count; i++) {
+                uint8_t* vertex = destination + i * s_stride;
+                (std::memcpy(vertex + s_offsets[J], sources[J] + i * s_sizes[J], s_sizes[J]), ...);
+            }
+        }
+
+        template<size_t... J>
+        static void deinterleave(const uint8_t* source, std::vector<BufferData>& dataBatch, const size_t count,
+                                 std::index_sequence<J...> /*unused*/) {
+            const std::array<uint8_t*, sizeof...(J)> destinations{dataBatch[J].data()...};
+            for (size_t i{}; i < count; i++) {
+                const uint8_t* vertex = source + i * s_stride;
+                (std::memcpy(destinations[J] + i * s_sizes[J], vertex + s_offsets[J], s_sizes[J]), ...);
+            }
+        }
+    };
+
+    using PosUvNormal = FixedLayout<12, 8, 12>;
+    using PosUvNormalTangent = FixedLayout<12, 8, 12, 12>;
+}
+
 Engine::Renderer::Buffer::BufferData Engine::Renderer::Buffer::Vertex::layoutInterleave(
     const Layout& layout, const std::vector<BufferData>& dataBatch) {
-    ASSERT(layout.getAttributes().size() == dataBatch.size());
+    const auto& attributes = layout.getAttributes();
+    ASSERT(attributes.size() == dataBatch.size());
 
     BufferData combinedBuffer;
 
     size_t minElements{std::numeric_limits<size_t>::max()};
     for (size_t i = 0; i < dataBatch.size(); i++) {
-        const size_t attrSize = Shader::dataTypeSize(layout.getAttributes()[i].dataType);
+        const size_t attrSize = Shader::dataTypeSize(attributes[i].dataType);
         ASSERT(attrSize > 0);
         ASSERT(dataBatch[i].size() % attrSize == 0); // Do they share the same alignment?
         minElements = std::min(minElements, dataBatch[i].size() / attrSize);
@@ -22,21 +94,69 @@ Engine::Renderer::Buffer::BufferData Engine::Renderer::Buffer::Vertex::layoutInt
 
     combinedBuffer.resize(minElements * layout.getStride());
 
-    for (ptrdiff_t i = 0; std::cmp_less(i, minElements); i++) {
-        ptrdiff_t offsetInStride = 0;
-        for (size_t j = 0; j < layout.getAttributes().size(); j++) {
-            const auto attributeSize = Shader::dataTypeSize(layout.getAttributes()[j].dataType);
-            std::copy_n(dataBatch[j].begin() + i * attributeSize,
-                        attributeSize,
-                        combinedBuffer.begin() + i * static_cast<ptrdiff_t>(layout.getStride()) +
-                        offsetInStride);
-            offsetInStride += attributeSize;
+    if (PosUvNormal::matches(layout)) {
+        PosUvNormal::interleave(dataBatch, combinedBuffer.data(), minElements);
+        return combinedBuffer;
+    }
+
+    if (PosUvNormalTangent::matches(layout)) {
+        PosUvNormalTangent::interleave(dataBatch, combinedBuffer.data(), minElements);
+        return combinedBuffer;
+    }
+
+    // Any other layout, one strided pass per attribute
+    const size_t stride = layout.getStride();
+    size_t offsetInStride{};
+    for (size_t j = 0; j < attributes.size(); j++) {
+        const size_t attributeSize = Shader::dataTypeSize(attributes[j].dataType);
+        const uint8_t* source = dataBatch[j].data();
+        uint8_t* destination = combinedBuffer.data() + offsetInStride;
+        for (size_t i = 0; i < minElements; i++) {
+            std::memcpy(destination + i * stride, source + i * attributeSize, attributeSize);
         }
+        offsetInStride += attributeSize;
     }
 
     return combinedBuffer;
 }
 
+std::vector<Engine::Renderer::Buffer::BufferData> Engine::Renderer::Buffer::Vertex::layoutDeinterleave(
+    const Layout& layout, const std::span<const uint8_t> vertexData) {
+    const auto& attributes = layout.getAttributes();
+    const size_t stride = layout.getStride();
+    ASSERT(stride > 0);
+    ASSERT(vertexData.size() % stride == 0);
+
+    const size_t vertexCount = vertexData.size() / stride;
+    std::vector<BufferData> dataBatch(attributes.size());
+    for (size_t j = 0; j < attributes.size(); j++) {
+        dataBatch[j].resize(vertexCount * Shader::dataTypeSize(attributes[j].dataType));
+    }
+
+    if (PosUvNormal::matches(layout)) {
+        PosUvNormal::deinterleave(vertexData.data(), dataBatch, vertexCount);
+        return dataBatch;
+    }
+
+    if (PosUvNormalTangent::matches(layout)) {
+        PosUvNormalTangent::deinterleave(vertexData.data(), dataBatch, vertexCount);
+        return dataBatch;
+    }
+
+    size_t offsetInStride{};
+    for (size_t j = 0; j < attributes.size(); j++) {
+        const size_t attributeSize = Shader::dataTypeSize(attributes[j].dataType);
+        const uint8_t* source = vertexData.data() + offsetInStride;
+        uint8_t* destination = dataBatch[j].data();
+        for (size_t i = 0; i < vertexCount; i++) {
+            std::memcpy(destination + i * attributeSize, source + i * stride, attributeSize);
+        }
+        offsetInStride += attributeSize;
+    }
+
+    return dataBatch;
+}
+
 Engine::Renderer::Buffer::Vertex::Vertex(Layout layout, const void* data, const uint32_t size) : m_layout{
     std::move(layout)
 } {
@@ -45,22 +165,25 @@ Engine::Renderer::Buffer::Vertex::Vertex(Layout layout, const void* data, const
     RENDERER_API_CALL(glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW));
 }
 
-Engine::Renderer::Buffer::Vertex::Vertex(Layout layout, const BufferData& bufferData) : m_layout{std::move(layout)} {
+Engine::Renderer::Buffer::Vertex::Vertex(Layout layout, const std::span<const uint8_t> bufferData) : m_layout{
+    std::move(layout)
+} {
     RENDERER_API_CALL(glGenBuffers(1, &m_id));
     bind();
-    RENDERER_API_CALL(glBufferData(GL_ARRAY_BUFFER, bufferData.size(), bufferData.data(), GL_STATIC_DRAW));
+    RENDERER_API_CALL(glBufferData(GL_ARRAY_BUFFER, bufferData.size_bytes(), bufferData.data(), GL_STATIC_DRAW));
 }
 
 Engine::Renderer::Buffer::Vertex::~Vertex() {
     RENDERER_API_CALL(glDeleteBuffers(1, &m_id));
+    GlState::current().onBufferDeleted(m_id);
 }
 
 void Engine::Renderer::Buffer::Vertex::bind() const {
-    RENDERER_API_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_id));
+    GlState::current().bindBuffer(GL_ARRAY_BUFFER, m_id);
 }
 
 void Engine::Renderer::Buffer::Vertex::unbind() {
-    RENDERER_API_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    GlState::current().bindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void Engine::Renderer::Buffer::Vertex::update(const void* vertexData, const uint32_t vertexCount) const {
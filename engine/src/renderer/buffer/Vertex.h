@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <vector>
 #include "Buffer.h"
 #include "renderer/shader/Shader.h"
@@ -38,22 +39,30 @@ namespace Engine::Renderer::Buffer {
                 (push(std::forward<Args>(args)), ...);
             }
 
-            [[nodiscard]] auto getAttributes() const { return m_attributes; }
+            [[nodiscard]] const auto& getAttributes() const { return m_attributes; }
 
             [[nodiscard]] auto getStride() const { return m_stride; }
 
+            // Attribute locations the whole layout takes up, see Shader::slotCount()
+            [[nodiscard]] uint32_t getSlotCount() const { return m_slotCount; }
+
         private:
             std::vector<Attribute> m_attributes;
             size_t m_stride{};
+            uint32_t m_slotCount{};
         };
 
+        // Common mesh layouts (vec3 vec2 vec3 and vec3 vec2 vec3 vec3) take a fixed stride path
         static BufferData layoutInterleave(const Layout& layout, const std::vector<BufferData>& dataBatch);
 
+        // Inverse of layoutInterleave(), splits interleaved vertex data back into one buffer per attribute
+        static std::vector<BufferData> layoutDeinterleave(const Layout& layout, std::span<const uint8_t> vertexData);
+
         Vertex() = delete;
 
         Vertex(Layout layout, const void* data, uint32_t size);
 
-        Vertex(Layout layout, const BufferData& bufferData);
+        Vertex(Layout layout, std::span<const uint8_t> bufferData);
 
         Vertex(const Vertex&) = delete;
 
@@ -92,8 +101,11 @@ namespace Engine::Renderer::Buffer {
     };
 
     inline void Vertex::Layout::push(const Attribute& element) {
+        ASSERT_MSG(!element.normalized || Shader::isIntegerDataType(element.dataType),
+                   "Only integer attributes can be normalized");
         m_attributes.push_back(element);
         m_stride += Shader::dataTypeSize(element.dataType);
+        m_slotCount += Shader::slotCount(element.dataType);
     }
 
     template<glm::length_t L, typename T, glm::qualifier Q>
@@ -102,7 +114,6 @@ namespace Engine::Renderer::Buffer {
         const auto dataType = Shader::toShaderDataType<VecType>();
         static_assert(dataType != Shader::DataType::None);
 
-        m_attributes.emplace_back(dataType, normalized);
-        m_stride += Shader::dataTypeSize(dataType);
+        push(Attribute{dataType, normalized});
     }
 }
@@ -0,0 +1,270 @@
+#include "MeshCache.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjParser.h"
+#include "core/Hash.h"
+#include "core/Log.h"
+
+namespace {
+    constexpr std::array<char, 4> s_magic{'F', 'P', 'S', 'M'};
+    constexpr uint32_t s_endianTag{0x01020304};
+    constexpr size_t s_blobAlignment{16};
+    constexpr size_t s_maxAttributes{8};
+    constexpr size_t s_maxLods{8};
+
+    struct Header {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint32_t endianTag;
+        uint32_t stride;
+        uint64_t sourceSize;
+        int64_t sourceMtime;
+        uint64_t sourceHash;
+        std::array<Engine::Renderer::Shader::DataType, s_maxAttributes> attributes;
+        uint32_t attributeCount;
+        uint32_t vertexCount;
+        uint32_t lodCount;
+        std::array<Engine::Renderer::MeshData::Lod, s_maxLods> lods;
+        Engine::Renderer::MeshData::Bounds bounds;
+        uint64_t vertexOffset;
+        uint64_t vertexSize;
+        uint64_t indexOffset;
+        uint64_t indexSize;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header>);
+
+    size_t alignUp(const size_t value) {
+        return (value + s_blobAlignment - 1) & ~(s_blobAlignment - 1);
+    }
+
+    std::optional<Header> readHeader(const std::span<const uint8_t> bytes) {
+        if (bytes.size() < sizeof(Header)) {
+            return std::nullopt;
+        }
+
+        Header header{};
+        std::memcpy(&header, bytes.data(), sizeof(Header));
+
+        if (header.magic != s_magic || header.version != Engine::Renderer::MeshCache::s_version ||
+            header.endianTag != s_endianTag) {
+            return std::nullopt;
+        }
+
+        if (header.vertexOffset + header.vertexSize > bytes.size() || header.indexOffset + header.indexSize > bytes.
+            size() || header.indexOffset % alignof(uint32_t) != 0 || header.indexSize % sizeof(uint32_t) != 0 ||
+            header.lodCount == 0 || header.lodCount > s_maxLods) {
+            return std::nullopt;
+        }
+
+        for (size_t i{}; i < header.lodCount; i++) {
+            const auto& lod = header.lods[i];
+            if (static_cast<uint64_t>(lod.indexOffset) + lod.indexCount > header.indexSize / sizeof(uint32_t)) {
+                return std::nullopt;
+            }
+        }
+
+        return header;
+    }
+
+    bool matchesBaseLayout(const Header& header) {
+        const auto layout = Engine::Renderer::MeshData::baseLayout();
+        const auto attributes = layout.getAttributes();
+
+        if (header.stride != layout.getStride() || header.attributeCount != attributes.size()) {
+            return false;
+        }
+
+        for (size_t i{}; i < attributes.size(); i++) {
+            if (header.attributes[i] != attributes[i].dataType) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+std::string Engine::Renderer::MeshCache::cookedPath(const std::string& sourcePath) {
+    const std::filesystem::path path{sourcePath};
+    const auto normalized = std::filesystem::weakly_canonical(path).generic_string();
+
+    // The path hash keeps equally named meshes from different directories apart
+    std::array<char, 17> pathHash{};
+    std::to_chars(pathHash.data(), pathHash.data() + pathHash.size() - 1, Hash::fnv1a64(normalized), 16);
+    return std::string{ENGINE_CACHE_PATH"/"} + path.stem().string() + '-' + pathHash.data() + ".fpsm";
+}
+
+std::vector<uint8_t> Engine::Renderer::MeshCache::cookToMemory(const std::string& sourcePath) {
+    const auto sourceInfo = CookedFile::getSourceInfo(sourcePath);
+    const MappedFile source{sourcePath};
+    if (!sourceInfo || !source.isOpen()) {
+        LOG_ERR("Could not cook mesh, source is missing: " << sourcePath);
+        return {};
+    }
+
+    ObjParser parser{sourcePath, ObjParser::Mode::PARALLEL};
+    auto meshData = parser.next();
+    if (meshData.isEmpty() || meshData.indices.empty()) {
+        LOG_ERR("Could not cook mesh, source has no geometry: " << sourcePath);
+        return {};
+    }
+
+    const auto& dedupStats = parser.getDedupStats();
+    LOG("Dedup table for " << sourcePath << ": " << dedupStats.size << " vertices, load factor " << dedupStats.
+        getLoadFactor() << ", average probe " << dedupStats.getAverageProbeLength() << ", max probe " << dedupStats.
+        maxProbeLength << '\n');
+
+    MeshSimplifier::generateLods(meshData, s_lodCount);
+
+    const auto fullMesh = std::span{meshData.indices}.first(meshData.getLods().front().indexCount);
+    const auto before = MeshOptimizer::analyzeVertexCache(fullMesh, meshData.positions.size());
+    MeshOptimizer::optimize(meshData);
+    const auto after = MeshOptimizer::analyzeVertexCache(fullMesh, meshData.positions.size());
+    LOG("Vertex cache for " << sourcePath << ": ACMR " << before.acmr << " -> " << after.acmr << ", ATVR " << before.
+        atvr << " -> " << after.atvr << '\n');
+
+    const auto layout = MeshData::baseLayout();
+    const auto attributes = layout.getAttributes();
+    ASSERT(attributes.size() <= s_maxAttributes);
+
+    const auto vertexData = Buffer::Vertex::layoutInterleave(layout, meshData.getVertexData());
+    const std::span indexData{meshData.indices};
+
+    Header header{};
+    header.magic = s_magic;
+    header.version = s_version;
+    header.endianTag = s_endianTag;
+    header.stride = static_cast<uint32_t>(layout.getStride());
+    header.sourceSize = sourceInfo->size;
+    header.sourceMtime = sourceInfo->mtime;
+    header.sourceHash = Hash::bytes(source.data(), source.size());
+    header.attributeCount = static_cast<uint32_t>(attributes.size());
+    for (size_t i{}; i < attributes.size(); i++) {
+        header.attributes[i] = attributes[i].dataType;
+    }
+    header.vertexCount = static_cast<uint32_t>(meshData.positions.size());
+    const auto lods = meshData.getLods();
+    ASSERT(lods.size() <= s_maxLods);
+    header.lodCount = static_cast<uint32_t>(lods.size());
+    std::ranges::copy(lods, header.lods.begin());
+    header.bounds = meshData.getBounds();
+    header.vertexOffset = alignUp(sizeof(Header));
+    header.vertexSize = vertexData.size();
+    header.indexOffset = alignUp(header.vertexOffset + header.vertexSize);
+    header.indexSize = indexData.size_bytes();
+
+    std::vector<uint8_t> bytes(header.indexOffset + header.indexSize);
+    std::memcpy(bytes.data(), &header, sizeof(Header));
+    std::memcpy(bytes.data() + header.vertexOffset, vertexData.data(), vertexData.size());
+    std::memcpy(bytes.data() + header.indexOffset, indexData.data(), indexData.size_bytes());
+    return bytes;
+}
+
+bool Engine::Renderer::MeshCache::cook(const std::string& sourcePath, const std::string& cookedPath) {
+    const auto bytes = cookToMemory(sourcePath);
+    return !bytes.empty() && store(sourcePath, cookedPath, bytes);
+}
+
+bool Engine::Renderer::MeshCache::store(const std::string& sourcePath, const std::string& cookedPath,
+                                        const std::span<const uint8_t> bytes) {
+    if (!CookedFile::write(cookedPath, bytes)) {
+        return false;
+    }
+
+    LOG("Cooked " << sourcePath << " -> " << cookedPath << '\n');
+    return true;
+}
+
+std::optional<Engine::Renderer::CookedMesh> Engine::Renderer::MeshCache::adopt(CookedMesh mesh,
+    const std::span<const uint8_t> bytes) {
+    const auto header = readHeader(bytes);
+    if (!header || !matchesBaseLayout(*header)) {
+        return std::nullopt;
+    }
+
+    mesh.m_vertexData = bytes.subspan(header->vertexOffset, header->vertexSize);
+    mesh.m_indexData = std::span{
+        reinterpret_cast<const uint32_t*>(bytes.data() + header->indexOffset), header->indexSize / sizeof(uint32_t)
+    };
+    mesh.m_vertexCount = header->vertexCount;
+    mesh.m_lods.assign(header->lods.begin(), header->lods.begin() + header->lodCount);
+    mesh.m_bounds = header->bounds;
+
+    if (!mesh.isValid()) {
+        return std::nullopt;
+    }
+
+    return mesh;
+}
+
+std::optional<Engine::Renderer::CookedMesh> Engine::Renderer::MeshCache::load(const std::string& cookedPath) {
+    if (!std::filesystem::exists(cookedPath)) {
+        return std::nullopt;
+    }
+
+    CookedMesh mesh;
+    mesh.m_file = MappedFile{cookedPath};
+    if (!mesh.m_file.isOpen()) {
+        return std::nullopt;
+    }
+
+    const std::span bytes{reinterpret_cast<const uint8_t*>(mesh.m_file.data()), mesh.m_file.size()};
+    return adopt(std::move(mesh), bytes);
+}
+
+Engine::Renderer::CookedFile::Freshness Engine::Renderer::MeshCache::checkSource(
+    const std::span<const uint8_t> bytes, const std::string& sourcePath) {
+    const auto header = readHeader(bytes);
+    if (!header) {
+        return CookedFile::Freshness::STALE;
+    }
+
+    return CookedFile::check(sourcePath, {header->sourceSize, header->sourceMtime}, header->sourceHash);
+}
+
+Engine::Renderer::CookedMesh Engine::Renderer::MeshCache::loadOrCook(const std::string& sourcePath) {
+    const auto path = cookedPath(sourcePath);
+
+    if (auto mesh = load(path)) {
+        const std::span bytes{reinterpret_cast<const uint8_t*>(mesh->m_file.data()), mesh->m_file.size()};
+        const auto freshness = checkSource(bytes, sourcePath);
+        if (freshness == CookedFile::Freshness::TOUCHED) {
+            // Recorded so the next launch does not hash the source again, written with the file unmapped
+            mesh.reset();
+            CookedFile::updateMtime(path, offsetof(Header, sourceMtime), sourcePath);
+            mesh = load(path);
+        }
+
+        if (mesh && freshness != CookedFile::Freshness::STALE) {
+            return std::move(*mesh);
+        }
+
+        if (freshness == CookedFile::Freshness::STALE) {
+            LOG("Cooked mesh is stale: " << path << '\n');
+        }
+    }
+
+    auto cooked = cookToMemory(sourcePath);
+    if (!cooked.empty() && store(sourcePath, path, cooked)) {
+        if (auto mesh = load(path)) {
+            return std::move(*mesh);
+        }
+    }
+
+    // The cache directory is not writable, keep the cooked bytes in memory for this run instead
+    CookedMesh mesh;
+    mesh.m_ownedData = std::move(cooked);
+    const std::span<const uint8_t> bytes{mesh.m_ownedData};
+    auto adopted = adopt(std::move(mesh), bytes);
+    ASSERT_MSG(adopted.has_value(), "Could not load or cook mesh: " << sourcePath);
+    return adopted ? std::move(*adopted) : CookedMesh{};
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "MeshData.h"
+#include "../CookedFile.h"
+#include "core/MappedFile.h"
+
+namespace Engine::Renderer {
+    // A mesh in cooked form. Vertex data is already optimized and interleaved in MeshData::baseLayout(), so both
+    // blobs can go straight to the gpu without touching them
+    class CookedMesh {
+    public:
+        [[nodiscard]] bool isValid() const {
+            return !m_indexData.empty();
+        }
+
+        [[nodiscard]] static Buffer::Vertex::Layout getLayout() {
+            return MeshData::baseLayout();
+        }
+
+        [[nodiscard]] std::span<const uint8_t> getVertexData() const {
+            return m_vertexData;
+        }
+
+        [[nodiscard]] std::span<const uint32_t> getIndexData() const {
+            return m_indexData;
+        }
+
+        [[nodiscard]] uint32_t getVertexCount() const {
+            return m_vertexCount;
+        }
+
+        [[nodiscard]] const std::vector<MeshData::Lod>& getLods() const {
+            return m_lods;
+        }
+
+        [[nodiscard]] const MeshData::Bounds& getBounds() const {
+            return m_bounds;
+        }
+
+    private:
+        friend class MeshCache;
+
+        MappedFile m_file;
+        std::vector<uint8_t> m_ownedData; // Only used if the cooked file could not be written
+        std::span<const uint8_t> m_vertexData;
+        std::span<const uint32_t> m_indexData;
+        uint32_t m_vertexCount{};
+        std::vector<MeshData::Lod> m_lods;
+        MeshData::Bounds m_bounds;
+    };
+
+    // Versioned binary cache for .obj meshes. Cooked files remember the size, modification time and content hash of
+    // their source, and are rebuilt when the source changes
+    class MeshCache {
+    public:
+        // 2: meshes are run through MeshOptimizer when cooked
+        // 3: levels of detail and bounds
+        static constexpr uint32_t s_version{3};
+        static constexpr uint32_t s_lodCount{4};
+
+        static std::string cookedPath(const std::string& sourcePath);
+
+        static bool cook(const std::string& sourcePath, const std::string& cookedPath);
+
+        // Loads a cooked file as is, without looking at its source
+        static std::optional<CookedMesh> load(const std::string& cookedPath);
+
+        // Loads the cooked version of sourcePath, cooking it first if it is missing or stale
+        static CookedMesh loadOrCook(const std::string& sourcePath);
+
+    private:
+        static std::vector<uint8_t> cookToMemory(const std::string& sourcePath);
+
+        static bool store(const std::string& sourcePath, const std::string& cookedPath, std::span<const uint8_t> bytes);
+
+        static std::optional<CookedMesh> adopt(CookedMesh mesh, std::span<const uint8_t> bytes);
+
+        static CookedFile::Freshness checkSource(std::span<const uint8_t> bytes, const std::string& sourcePath);
+    };
+}
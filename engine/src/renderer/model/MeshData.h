@@ -1,5 +1,8 @@
 #pragma once
+#include <algorithm>
 #include <vector>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
@@ -7,6 +10,18 @@
 
 namespace Engine::Renderer {
     struct MeshData {
+        // A level of detail is a range inside indices. Every level shares the same vertices.
+        struct Lod {
+            uint32_t indexOffset{};
+            uint32_t indexCount{};
+            float error{}; // Largest deviation from the full mesh, relative to the bounding radius
+        };
+
+        struct Bounds {
+            glm::vec3 center{};
+            float radius{};
+        };
+
         static Buffer::Vertex::Layout baseLayout() {
             return Buffer::Vertex::Layout{
                 decltype(positions)::value_type{},
@@ -25,9 +40,38 @@ namespace Engine::Renderer {
             };
         }
 
+        [[nodiscard]] std::vector<Lod> getLods() const {
+            if (lods.empty()) {
+                return {Lod{0, static_cast<uint32_t>(indices.size()), 0.f}};
+            }
+
+            return lods;
+        }
+
+        [[nodiscard]] Bounds getBounds() const {
+            if (positions.empty()) {
+                return {};
+            }
+
+            glm::vec3 min{positions.front()};
+            glm::vec3 max{positions.front()};
+            for (const auto& position: positions) {
+                min = glm::min(min, position);
+                max = glm::max(max, position);
+            }
+
+            Bounds bounds{(min + max) * .5f, 0.f};
+            for (const auto& position: positions) {
+                bounds.radius = std::max(bounds.radius, glm::length(position - bounds.center));
+            }
+
+            return bounds;
+        }
+
         std::vector<glm::vec3> positions;
         std::vector<glm::vec2> textureCoords;
         std::vector<glm::vec3> normals;
         std::vector<uint32_t> indices;
+        std::vector<Lod> lods; // Empty means indices is a single level
     };
 }
@@ -0,0 +1,297 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <glm/geometric.hpp>
+
+#include "core/Assert.h"
+
+namespace {
+    constexpr uint32_t s_noVertex{std::numeric_limits<uint32_t>::max()};
+
+    // Triangles using each vertex, as one flat array with per vertex offsets into it
+    struct Adjacency {
+        Adjacency(const std::span<const uint32_t> indices, const size_t vertexCount) : offsets(vertexCount + 1),
+            triangles(indices.size()) {
+            for (const uint32_t index: indices) {
+                ASSERT_MSG(index < vertexCount, "Index out of range: " << index);
+                offsets[index + 1]++;
+            }
+
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            std::vector<uint32_t> fill{offsets.begin(), offsets.end() - 1};
+            for (size_t i{}; i < indices.size(); i++) {
+                triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        [[nodiscard]] std::span<const uint32_t> of(const uint32_t vertex) const {
+            return std::span{triangles}.subspan(offsets[vertex], offsets[vertex + 1] - offsets[vertex]);
+        }
+
+        [[nodiscard]] uint32_t count(const uint32_t vertex) const {
+            return offsets[vertex + 1] - offsets[vertex];
+        }
+
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> triangles;
+    };
+}
+
+Engine::Renderer::MeshOptimizer::CacheStats Engine::Renderer::MeshOptimizer::analyzeVertexCache(
+    const std::span<const uint32_t> indices, const size_t vertexCount, const uint32_t cacheSize) {
+    // A vertex is in the cache while fewer than cacheSize misses have happened since it was loaded
+    std::vector<uint32_t> loadedAt(vertexCount, 0);
+    uint32_t misses{};
+    uint32_t time{cacheSize + 1};
+    uint32_t referenced{};
+
+    for (const uint32_t index: indices) {
+        ASSERT_MSG(index < vertexCount, "Index out of range: " << index);
+        referenced += loadedAt[index] == 0 ? 1u : 0u;
+
+        if (time - loadedAt[index] > cacheSize) {
+            loadedAt[index] = time++;
+            misses++;
+        }
+    }
+
+    const size_t triangleCount = indices.size() / 3;
+    return CacheStats{
+        triangleCount == 0 ? 0.f : static_cast<float>(misses) / static_cast<float>(triangleCount),
+        referenced == 0 ? 0.f : static_cast<float>(misses) / static_cast<float>(referenced),
+        misses
+    };
+}
+
+std::vector<uint32_t> Engine::Renderer::MeshOptimizer::optimizeVertexCache(const std::span<uint32_t> indices,
+                                                                           const size_t vertexCount,
+                                                                           const uint32_t cacheSize) {
+    ASSERT_MSG(indices.size() % 3 == 0, "Index count is not a multiple of 3");
+
+    std::vector<uint32_t> clusters;
+    if (indices.empty() || vertexCount == 0) {
+        return clusters;
+    }
+
+    const Adjacency adjacency{indices, vertexCount};
+
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (uint32_t v{}; v < vertexCount; v++) {
+        liveTriangles[v] = adjacency.count(v);
+    }
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t time{cacheSize + 1};
+    std::vector<bool> emitted(indices.size() / 3);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    uint32_t cursor{1};
+    auto skipDeadEnd = [&]() -> uint32_t {
+        while (!deadEnd.empty()) {
+            const uint32_t vertex = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveTriangles[vertex] > 0) {
+                return vertex;
+            }
+        }
+
+        for (; cursor < vertexCount; cursor++) {
+            if (liveTriangles[cursor] > 0) {
+                return cursor;
+            }
+        }
+
+        return s_noVertex;
+    };
+
+    uint32_t fanning{0};
+    clusters.push_back(0);
+    while (fanning != s_noVertex) {
+        candidates.clear();
+
+        for (const uint32_t triangle: adjacency.of(fanning)) {
+            if (emitted[triangle]) {
+                continue;
+            }
+
+            for (size_t k{}; k < 3; k++) {
+                const uint32_t vertex = indices[triangle * 3 + k];
+                output.push_back(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+
+                if (time - cacheTime[vertex] > cacheSize) {
+                    cacheTime[vertex] = time++;
+                }
+            }
+
+            emitted[triangle] = true;
+        }
+
+        // Prefer the candidate that is still in the cache and whose remaining fan fits before it gets evicted
+        uint32_t best{s_noVertex};
+        int64_t bestPriority{-1};
+        for (const uint32_t vertex: candidates) {
+            if (liveTriangles[vertex] == 0) {
+                continue;
+            }
+
+            int64_t priority{};
+            if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize) {
+                priority = time - cacheTime[vertex];
+            }
+
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best = vertex;
+            }
+        }
+
+        if (best == s_noVertex) {
+            const auto emittedTriangles = static_cast<uint32_t>(output.size() / 3);
+            if (emittedTriangles != clusters.back() && emittedTriangles * 3 != indices.size()) {
+                clusters.push_back(emittedTriangles);
+            }
+
+            best = skipDeadEnd();
+        }
+
+        fanning = best;
+    }
+
+    ASSERT(output.size() == indices.size());
+    std::ranges::copy(output, indices.begin());
+    return clusters;
+}
+
+void Engine::Renderer::MeshOptimizer::optimizeOverdraw(const std::span<uint32_t> indices,
+                                                       const std::span<const glm::vec3> positions,
+                                                       const std::span<const uint32_t> clusters,
+                                                       const float threshold, const uint32_t cacheSize) {
+    if (clusters.size() <= 1) {
+        return;
+    }
+
+    glm::vec3 meshCentroid{};
+    for (const auto& position: positions) {
+        meshCentroid += position;
+    }
+    meshCentroid /= static_cast<float>(positions.size());
+
+    // Clusters facing away from the center are likely to occlude the ones facing inward, so draw them first
+    std::vector<float> sortKeys(clusters.size());
+    for (size_t c{}; c < clusters.size(); c++) {
+        const size_t begin = clusters[c] * size_t{3};
+        const size_t end = c + 1 < clusters.size() ? clusters[c + 1] * size_t{3} : indices.size();
+
+        glm::vec3 centroid{};
+        glm::vec3 normal{};
+        float area{};
+        for (size_t i{begin}; i < end; i += 3) {
+            const auto& p0 = positions[indices[i]];
+            const auto& p1 = positions[indices[i + 1]];
+            const auto& p2 = positions[indices[i + 2]];
+            const auto faceNormal = glm::cross(p1 - p0, p2 - p0); // Length is twice the area
+            const float faceArea = glm::length(faceNormal);
+
+            centroid += (p0 + p1 + p2) * (faceArea / 3.f);
+            normal += faceNormal;
+            area += faceArea;
+        }
+
+        const float normalLength = glm::length(normal);
+        if (area <= 0.f || normalLength <= 0.f) {
+            continue;
+        }
+
+        sortKeys[c] = glm::dot(centroid / area - meshCentroid, normal / normalLength);
+    }
+
+    std::vector<uint32_t> order(clusters.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, [&sortKeys](const uint32_t a, const uint32_t b) {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(indices.size());
+    for (const uint32_t c: order) {
+        const size_t begin = clusters[c] * size_t{3};
+        const size_t end = c + 1 < clusters.size() ? clusters[c + 1] * size_t{3} : indices.size();
+        sorted.insert(sorted.end(), indices.begin() + static_cast<ptrdiff_t>(begin),
+                      indices.begin() + static_cast<ptrdiff_t>(end));
+    }
+
+    const float currentAcmr = analyzeVertexCache(indices, positions.size(), cacheSize).acmr;
+    const float sortedAcmr = analyzeVertexCache(sorted, positions.size(), cacheSize).acmr;
+    if (sortedAcmr <= currentAcmr * threshold) {
+        std::ranges::copy(sorted, indices.begin());
+    }
+}
+
+void Engine::Renderer::MeshOptimizer::optimizeVertexFetch(MeshData& meshData) {
+    const size_t vertexCount = meshData.positions.size();
+    std::vector<uint32_t> remap(vertexCount, s_noVertex);
+    uint32_t nextVertex{};
+
+    for (uint32_t& index: meshData.indices) {
+        ASSERT_MSG(index < vertexCount, "Index out of range: " << index);
+        if (remap[index] == s_noVertex) {
+            remap[index] = nextVertex++;
+        }
+
+        index = remap[index];
+    }
+
+    auto reorder = [&remap, vertexCount, nextVertex]<typename T>(std::vector<T>& attribute) {
+        if (attribute.size() != vertexCount) {
+            return;
+        }
+
+        std::vector<T> reordered(nextVertex);
+        for (size_t v{}; v < vertexCount; v++) {
+            if (remap[v] != s_noVertex) {
+                reordered[remap[v]] = attribute[v];
+            }
+        }
+
+        attribute = std::move(reordered);
+    };
+
+    reorder(meshData.positions);
+    reorder(meshData.textureCoords);
+    reorder(meshData.normals);
+}
+
+void Engine::Renderer::MeshOptimizer::optimize(MeshData& meshData, const uint32_t cacheSize) {
+    if (meshData.indices.empty()) {
+        return;
+    }
+
+    const size_t vertexCount = meshData.positions.size();
+
+    // Every level of detail is its own range of triangles
+    for (const auto& lod: meshData.getLods()) {
+        const auto indices = std::span{meshData.indices}.subspan(lod.indexOffset, lod.indexCount);
+        const std::vector<uint32_t> original{indices.begin(), indices.end()};
+        const float originalAcmr = analyzeVertexCache(original, vertexCount, cacheSize).acmr;
+
+        const auto clusters = optimizeVertexCache(indices, vertexCount, cacheSize);
+        optimizeOverdraw(indices, meshData.positions, clusters, 1.05f, cacheSize);
+
+        // Tiny meshes that already fit the cache can come out slightly worse, keep the file order for those
+        if (analyzeVertexCache(indices, vertexCount, cacheSize).acmr > originalAcmr) {
+            std::ranges::copy(original, indices.begin());
+        }
+    }
+
+    // The full mesh comes first in the index buffer, so it decides the vertex order
+    optimizeVertexFetch(meshData);
+}
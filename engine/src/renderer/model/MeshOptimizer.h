@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "MeshData.h"
+
+// Reorders MeshData for the gpu. Run it before Model::generate, the geometry itself is never changed.
+namespace Engine::Renderer::MeshOptimizer {
+    inline constexpr uint32_t s_defaultCacheSize{16};
+
+    struct CacheStats {
+        float acmr{}; // Average cache miss ratio, transformed vertices per triangle. 0.5 is the best possible
+        float atvr{}; // Average transformed vertex ratio, 1.0 means every vertex was transformed exactly once
+        uint32_t transformedVertices{};
+    };
+
+    // Simulates a FIFO post-transform cache on the cpu
+    CacheStats analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+                                  uint32_t cacheSize = s_defaultCacheSize);
+
+    // Tipsify (Sander et al. 2007). Returns the triangle offsets where the cache is effectively flushed, which
+    // optimizeOverdraw() uses as cluster boundaries.
+    std::vector<uint32_t> optimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount,
+                                              uint32_t cacheSize = s_defaultCacheSize);
+
+    // Sorts the clusters found by optimizeVertexCache() so outward facing ones are drawn first. Only applied if
+    // the ACMR does not get worse than threshold times the current one.
+    void optimizeOverdraw(std::span<uint32_t> indices, std::span<const glm::vec3> positions,
+                          std::span<const uint32_t> clusters, float threshold = 1.05f,
+                          uint32_t cacheSize = s_defaultCacheSize);
+
+    // Renumbers vertices in the order they are first referenced. Unreferenced vertices are dropped.
+    void optimizeVertexFetch(MeshData& meshData);
+
+    // All of the above in the right order
+    void optimize(MeshData& meshData, uint32_t cacheSize = s_defaultCacheSize);
+}
@@ -0,0 +1,323 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+
+#include "VertexDedupTable.h"
+#include "core/Assert.h"
+
+namespace {
+    // Sum of squared distances to a set of planes, weighted by triangle area
+    struct Quadric {
+        static Quadric fromTriangle(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+            const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            const float doubleArea = glm::length(normal);
+            if (doubleArea <= 0.f) {
+                return {};
+            }
+
+            const glm::dvec3 n = glm::dvec3{normal / doubleArea};
+            const double d = -glm::dot(n, glm::dvec3{p0});
+            const double w = doubleArea * .5;
+
+            return Quadric{
+                w * n.x * n.x, w * n.x * n.y, w * n.x * n.z, w * n.y * n.y, w * n.y * n.z, w * n.z * n.z,
+                w * n.x * d, w * n.y * d, w * n.z * d, w * d * d, w
+            };
+        }
+
+        Quadric& operator+=(const Quadric& other) {
+            a00 += other.a00;
+            a01 += other.a01;
+            a02 += other.a02;
+            a11 += other.a11;
+            a12 += other.a12;
+            a22 += other.a22;
+            b0 += other.b0;
+            b1 += other.b1;
+            b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+            return *this;
+        }
+
+        Quadric operator+(const Quadric& other) const {
+            Quadric sum = *this;
+            sum += other;
+            return sum;
+        }
+
+        // Area weighted mean squared distance from point to the planes
+        [[nodiscard]] double evaluate(const glm::vec3& point) const {
+            if (weight <= 0.0) {
+                return 0.0;
+            }
+
+            const double x = point.x;
+            const double y = point.y;
+            const double z = point.z;
+            const double error = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + a11 * y * y + 2 * a12 * y * z +
+                                 a22 * z * z + 2 * (b0 * x + b1 * y + b2 * z) + c;
+            return std::max(0.0, error / weight);
+        }
+
+        double a00{}, a01{}, a02{}, a11{}, a12{}, a22{};
+        double b0{}, b1{}, b2{};
+        double c{};
+        double weight{};
+    };
+
+    struct Collapse {
+        uint32_t from;
+        uint32_t to;
+        double cost;
+    };
+
+    // Maps every vertex to the first vertex with the exact same position. Vertices that share a position with
+    // another one sit on a uv or normal seam.
+    std::vector<uint32_t> weldPositions(const std::span<const glm::vec3> positions) {
+        Engine::Renderer::VertexDedupTable table{positions.size()};
+        std::vector<uint32_t> canonical(positions.size());
+        for (size_t v{}; v < positions.size(); v++) {
+            const auto& p = positions[v];
+            const Engine::Renderer::VertexDedupTable::Key key{
+                std::bit_cast<uint32_t>(p.x), std::bit_cast<uint32_t>(p.y), std::bit_cast<uint32_t>(p.z)
+            };
+            canonical[v] = table.findOrInsert(key, static_cast<uint32_t>(v)).first;
+        }
+
+        return canonical;
+    }
+
+    uint64_t edgeKey(uint32_t a, uint32_t b) {
+        if (a > b) {
+            std::swap(a, b);
+        }
+
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    bool collapseFlipsTriangle(const std::span<const uint32_t> indices, const std::span<const glm::vec3> positions,
+                               const std::span<const uint32_t> trianglesAround, const uint32_t from,
+                               const uint32_t to) {
+        for (const uint32_t triangle: trianglesAround) {
+            const uint32_t* corners = &indices[triangle * 3];
+            if (corners[0] == to || corners[1] == to || corners[2] == to) {
+                continue; // Removed by the collapse
+            }
+
+            glm::vec3 p[3];
+            glm::vec3 moved[3];
+            for (size_t k{}; k < 3; k++) {
+                p[k] = positions[corners[k]];
+                moved[k] = corners[k] == from ? positions[to] : p[k];
+            }
+
+            const glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+            const glm::vec3 after = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+            if (glm::dot(before, after) <= 0.f) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
+
+std::vector<uint32_t> Engine::Renderer::MeshSimplifier::simplify(const std::span<const uint32_t> indices,
+                                                                 const std::span<const glm::vec3> positions,
+                                                                 const size_t targetIndexCount, const float maxError,
+                                                                 float* resultError) {
+    ASSERT_MSG(indices.size() % 3 == 0, "Index count is not a multiple of 3");
+    const size_t vertexCount = positions.size();
+
+    std::vector<uint32_t> result{indices.begin(), indices.end()};
+    float achievedError{};
+
+    const auto canonical = weldPositions(positions);
+
+    // Seam and border vertices are locked, collapsing them would tear the mesh open
+    std::vector<bool> locked(vertexCount);
+    {
+        std::vector<uint32_t> sharing(vertexCount);
+        for (size_t v{}; v < vertexCount; v++) {
+            sharing[canonical[v]]++;
+        }
+
+        std::unordered_map<uint64_t, uint32_t> edgeUse;
+        edgeUse.reserve(result.size());
+        for (size_t i{}; i < result.size(); i += 3) {
+            for (size_t k{}; k < 3; k++) {
+                edgeUse[edgeKey(canonical[result[i + k]], canonical[result[i + (k + 1) % 3]])]++;
+            }
+        }
+
+        for (const auto& [edge, useCount]: edgeUse) {
+            if (useCount != 2) {
+                locked[static_cast<uint32_t>(edge >> 32)] = true;
+                locked[static_cast<uint32_t>(edge)] = true;
+            }
+        }
+
+        for (size_t v{}; v < vertexCount; v++) {
+            locked[v] = locked[canonical[v]] || sharing[canonical[v]] > 1;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i{}; i < result.size(); i += 3) {
+        const auto quadric = Quadric::fromTriangle(positions[result[i]], positions[result[i + 1]],
+                                                   positions[result[i + 2]]);
+        for (size_t k{}; k < 3; k++) {
+            quadrics[canonical[result[i + k]]] += quadric;
+        }
+    }
+
+    const double maxCost = static_cast<double>(maxError) * static_cast<double>(maxError);
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<uint32_t> offsets(vertexCount + 1);
+    std::vector<uint32_t> trianglesAround;
+    std::vector<Collapse> collapses;
+
+    // Each pass collapses a set of edges that don't share any triangles, then rebuilds the mesh
+    while (result.size() > targetIndexCount) {
+        std::ranges::fill(offsets, 0);
+        for (const uint32_t index: result) {
+            offsets[index + 1]++;
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        trianglesAround.resize(result.size());
+        {
+            std::vector<uint32_t> fill{offsets.begin(), offsets.end() - 1};
+            for (size_t i{}; i < result.size(); i++) {
+                trianglesAround[fill[result[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        collapses.clear();
+        for (size_t i{}; i < result.size(); i += 3) {
+            for (size_t k{}; k < 3; k++) {
+                const uint32_t a = result[i + k];
+                const uint32_t b = result[i + (k + 1) % 3];
+
+                // Interior edges show up once in each direction, only look at them once. Border edges can be
+                // skipped, both of their vertices are locked.
+                if (a > b || (locked[a] && locked[b])) {
+                    continue;
+                }
+
+                const Quadric quadric = quadrics[canonical[a]] + quadrics[canonical[b]];
+                const double costToB = locked[a] ? maxCost + 1 : quadric.evaluate(positions[b]);
+                const double costToA = locked[b] ? maxCost + 1 : quadric.evaluate(positions[a]);
+                const auto collapse = costToB <= costToA ? Collapse{a, b, costToB} : Collapse{b, a, costToA};
+                if (collapse.cost <= maxCost) {
+                    collapses.push_back(collapse);
+                }
+            }
+        }
+
+        std::ranges::sort(collapses, [](const Collapse& a, const Collapse& b) {
+            return a.cost < b.cost;
+        });
+
+        std::iota(remap.begin(), remap.end(), 0);
+        std::fill(touched.begin(), touched.end(), false);
+        size_t triangleCount = result.size() / 3;
+        const size_t targetTriangleCount = targetIndexCount / 3;
+        size_t collapsed{};
+
+        for (const auto& [from, to, cost]: collapses) {
+            if (triangleCount <= targetTriangleCount) {
+                break;
+            }
+
+            if (touched[from] || touched[to]) {
+                continue;
+            }
+
+            const std::span around = std::span{trianglesAround}.subspan(offsets[from], offsets[from + 1] -
+                                                                                      offsets[from]);
+            if (collapseFlipsTriangle(result, positions, around, from, to)) {
+                continue;
+            }
+
+            remap[from] = to;
+            quadrics[canonical[to]] += quadrics[canonical[from]];
+            achievedError = std::max(achievedError, static_cast<float>(std::sqrt(cost)));
+            collapsed++;
+
+            // Everything around the collapsed vertex changed, so it may not take part in another collapse this pass
+            for (const uint32_t triangle: around) {
+                const uint32_t* corners = &result[triangle * 3];
+                const bool removed = corners[0] == to || corners[1] == to || corners[2] == to;
+                triangleCount -= removed ? 1 : 0;
+                for (size_t k{}; k < 3; k++) {
+                    touched[corners[k]] = true;
+                }
+            }
+        }
+
+        if (collapsed == 0) {
+            break;
+        }
+
+        size_t write{};
+        for (size_t i{}; i < result.size(); i += 3) {
+            const uint32_t a = remap[result[i]];
+            const uint32_t b = remap[result[i + 1]];
+            const uint32_t c = remap[result[i + 2]];
+            if (a == b || b == c || a == c) {
+                continue;
+            }
+
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    if (resultError != nullptr) {
+        *resultError = achievedError;
+    }
+
+    return result;
+}
+
+void Engine::Renderer::MeshSimplifier::generateLods(MeshData& meshData, const uint32_t levelCount,
+                                                    const float reduction, const float maxError) {
+    ASSERT_MSG(meshData.lods.empty(), "Mesh already has levels of detail");
+
+    const auto bounds = meshData.getBounds();
+    const std::vector<uint32_t> full = meshData.indices;
+    meshData.lods.push_back(MeshData::Lod{0, static_cast<uint32_t>(full.size()), 0.f});
+
+    // Every level is simplified from the full mesh, so its error is measured against the full mesh too
+    for (uint32_t level{1}; level < levelCount; level++) {
+        const size_t previousCount = meshData.lods.back().indexCount;
+        const size_t target = static_cast<size_t>(static_cast<float>(previousCount) * reduction) / 3 * 3;
+
+        float error{};
+        const auto simplified = simplify(full, meshData.positions, target, maxError * bounds.radius, &error);
+
+        // Not worth a level if the simplifier could barely remove anything
+        if (static_cast<float>(simplified.size()) > static_cast<float>(previousCount) * .9f) {
+            break;
+        }
+
+        meshData.lods.push_back(MeshData::Lod{
+            static_cast<uint32_t>(meshData.indices.size()), static_cast<uint32_t>(simplified.size()),
+            bounds.radius > 0.f ? error / bounds.radius : 0.f
+        });
+        meshData.indices.insert(meshData.indices.end(), simplified.begin(), simplified.end());
+    }
+
+    if (meshData.lods.size() == 1) {
+        meshData.lods.clear();
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "MeshData.h"
+
+namespace Engine::Renderer::MeshSimplifier {
+    // Quadric error metric simplification through half edge collapses. A vertex is only ever moved onto one of its
+    // neighbours, so the result indexes the same vertex buffer as the input. Vertices on borders and on uv/normal
+    // seams are never moved. Stops at targetIndexCount or when the next collapse would exceed maxError (world
+    // units), whichever comes first.
+    std::vector<uint32_t> simplify(std::span<const uint32_t> indices, std::span<const glm::vec3> positions,
+                                   size_t targetIndexCount, float maxError, float* resultError = nullptr);
+
+    // Appends up to levelCount - 1 levels after the full mesh, each with about reduction times the triangles of the
+    // level before it. maxError is relative to the bounding radius.
+    void generateLods(MeshData& meshData, uint32_t levelCount, float reduction = .5f, float maxError = .1f);
+}
@@ -1,6 +1,8 @@
 #include "Model.h"
 
+#include <cstring>
 #include <fstream>
+#include <numeric>
 
 #include "../Renderer.h"
 #include "../shader/Program.h"
@@ -13,30 +15,157 @@ Engine::Renderer::Model Engine::Renderer::Model::generate(const MeshData& meshDa
     Buffer::Vertex vertexBuffer{layout, interleavedData};
 
     return Model{
-        VertexArray{std::move(vertexBuffer), meshData.indices},
+        VertexArray{std::move(vertexBuffer), meshData.indices}, meshData.getLods(), meshData.getBounds(),
         std::move(textures)
     };
 }
 
-void Engine::Renderer::Model::draw(const Shader::Program& shaderProgram) const {
+Engine::Renderer::Model Engine::Renderer::Model::generate(const CookedMesh& cookedMesh,
+                                                          std::vector<Texture> textures) {
+    ASSERT_MSG(cookedMesh.isValid(), "Cannot generate model from an invalid cooked mesh");
+
+    Buffer::Vertex vertexBuffer{CookedMesh::getLayout(), cookedMesh.getVertexData()};
+
+    return Model{
+        VertexArray{std::move(vertexBuffer), cookedMesh.getIndexData()}, cookedMesh.getLods(),
+        cookedMesh.getBounds(), std::move(textures)
+    };
+}
+
+Engine::Renderer::Model Engine::Renderer::Model::generateCompressed(const MeshData& meshData,
+                                                                    std::vector<Texture> textures) {
+    VertexCompression::Dequantization dequantization;
+    const auto vertices = VertexCompression::compress(meshData, dequantization);
+
+    const std::span vertexData{
+        reinterpret_cast<const uint8_t*>(vertices.data()), vertices.size() * sizeof(VertexCompression::Vertex)
+    };
+    Buffer::Vertex vertexBuffer{VertexCompression::layout(), vertexData};
+
+    return Model{
+        VertexArray{std::move(vertexBuffer), meshData.indices}, meshData.getLods(), meshData.getBounds(),
+        std::move(textures), dequantization
+    };
+}
+
+Engine::Renderer::Model Engine::Renderer::Model::generateCompressed(const CookedMesh& cookedMesh,
+                                                                    std::vector<Texture> textures) {
+    ASSERT_MSG(cookedMesh.isValid(), "Cannot generate model from an invalid cooked mesh");
+
+    // Back to one array per attribute, the form VertexCompression reads
+    const auto attributes = Buffer::Vertex::layoutDeinterleave(CookedMesh::getLayout(), cookedMesh.getVertexData());
+    MeshData meshData;
+    meshData.positions.resize(cookedMesh.getVertexCount());
+    meshData.textureCoords.resize(cookedMesh.getVertexCount());
+    meshData.normals.resize(cookedMesh.getVertexCount());
+    std::memcpy(meshData.positions.data(), attributes[0].data(), attributes[0].size());
+    std::memcpy(meshData.textureCoords.data(), attributes[1].data(), attributes[1].size());
+    std::memcpy(meshData.normals.data(), attributes[2].data(), attributes[2].size());
+    meshData.indices.assign(cookedMesh.getIndexData().begin(), cookedMesh.getIndexData().end());
+    meshData.lods = cookedMesh.getLods();
+
+    return generateCompressed(meshData, std::move(textures));
+}
+
+void Engine::Renderer::Model::draw(const Shader::Program& shaderProgram, const uint32_t lod) const {
+    ASSERT(lod < m_lods.size());
     m_vertexArray.bind();
     shaderProgram.bind();
     RENDERER_API_CALL(
-        glDrawElements(GL_TRIANGLES, m_vertexArray.getIndexBuffer().getCount(), GL_UNSIGNED_INT, nullptr));
+        glDrawElements(GL_TRIANGLES, m_lods[lod].indexCount, GL_UNSIGNED_INT,
+            reinterpret_cast<const void*>(m_lods[lod].indexOffset * sizeof(uint32_t))));
+}
+
+void Engine::Renderer::Model::submit(RenderQueue& renderQueue, RenderQueue::Packet packet, const uint32_t lod) const {
+    ASSERT(lod < m_lods.size());
+    packet.vertexArray = &m_vertexArray;
+    for (size_t slot{}; slot < std::min(m_textures.size(), RenderQueue::s_textureSlots); slot++) {
+        packet.textures[slot] = &m_textures[slot];
+    }
+    packet.indexOffset = m_lods[lod].indexOffset;
+    packet.indexCount = m_lods[lod].indexCount;
+    renderQueue.submit(packet);
 }
 
 void Engine::Renderer::Model::drawInstanced(const Shader::Program& shaderProgram, const void* instanceData,
-                                            const uint32_t instanceCount) const {
+                                            const uint32_t instanceCount) {
+    ASSERT_MSG(m_vertexArray.isInstantiable(), "Model cannot be drawn instanced. No instance buffer is set.");
+
+    const auto instances = m_vertexArray.mapInstances(instanceCount);
+    std::memcpy(instances.data(), instanceData, instances.size());
+    drawInstanced(shaderProgram, instanceCount);
+}
+
+void Engine::Renderer::Model::drawInstanced(const Shader::Program& shaderProgram, const uint32_t instanceCount) {
     ASSERT_MSG(m_vertexArray.isInstantiable(), "Model cannot be drawn instanced. No instance buffer is set.");
 
+    m_vertexArray.commitInstances();
     m_vertexArray.bind();
-    m_vertexArray.updateInstanceBuffer(instanceData, instanceCount);
     shaderProgram.bind();
     RENDERER_API_CALL(
-        glDrawElementsInstanced(GL_TRIANGLES, m_vertexArray.getIndexBuffer().getCount(), GL_UNSIGNED_INT,
+        glDrawElementsInstanced(GL_TRIANGLES, m_lods.front().indexCount, GL_UNSIGNED_INT,
             nullptr, instanceCount));
 }
 
-void Engine::Renderer::Model::setInstanceBuffer(Buffer::Vertex instanceBuffer) {
-    m_vertexArray.setInstanceBuffer(std::move(instanceBuffer));
+void Engine::Renderer::Model::drawInstancedLod(const Shader::Program& shaderProgram, const void* instanceData,
+                                               const std::span<const uint8_t> instanceLods) {
+    ASSERT_MSG(m_vertexArray.isInstantiable(), "Model cannot be drawn instanced. No instance buffer is set.");
+
+    const size_t stride = m_vertexArray.getInstanceBuffer().getLayout().getStride();
+    const auto* instances = static_cast<const uint8_t*>(instanceData);
+
+    // Counting sort of the instances by level, so every level is one contiguous range of the instance buffer
+    std::vector<uint32_t> firstInstance(m_lods.size() + 1);
+    for (const uint8_t lod: instanceLods) {
+        ASSERT(lod < m_lods.size());
+        firstInstance[lod + 1]++;
+    }
+    std::partial_sum(firstInstance.begin(), firstInstance.end(), firstInstance.begin());
+
+    // Sorted straight into the instance buffer
+    const auto sorted = m_vertexArray.mapInstances(static_cast<uint32_t>(instanceLods.size()));
+    std::vector<uint32_t> fill{firstInstance.begin(), firstInstance.end() - 1};
+    for (size_t i{}; i < instanceLods.size(); i++) {
+        std::memcpy(sorted.data() + fill[instanceLods[i]]++ * stride, instances + i * stride, stride);
+    }
+
+    m_vertexArray.commitInstances();
+    m_vertexArray.bind();
+    shaderProgram.bind();
+
+    for (size_t lod{}; lod < m_lods.size(); lod++) {
+        const uint32_t count = firstInstance[lod + 1] - firstInstance[lod];
+        if (count == 0) {
+            continue;
+        }
+
+        m_vertexArray.setInstanceBase(firstInstance[lod]);
+        RENDERER_API_CALL(
+            glDrawElementsInstanced(GL_TRIANGLES, m_lods[lod].indexCount, GL_UNSIGNED_INT,
+                reinterpret_cast<const void*>(m_lods[lod].indexOffset * sizeof(uint32_t)), count));
+    }
+}
+
+uint8_t Engine::Renderer::Model::selectLod(const float screenSize, const float threshold) const {
+    // Lod errors are relative to the bounding radius, which is half of the projected size
+    for (size_t lod{m_lods.size() - 1}; lod > 0; lod--) {
+        if (m_lods[lod].error * screenSize * .5f <= threshold) {
+            return static_cast<uint8_t>(lod);
+        }
+    }
+
+    return 0;
+}
+
+void Engine::Renderer::Model::applyDequantization(const Shader::Program& shaderProgram) const {
+    ASSERT_MSG(m_dequantization.has_value(), "Model is not compressed");
+
+    shaderProgram.setUniform("u_positionOffset", m_dequantization->positionOffset);
+    shaderProgram.setUniform("u_positionScale", m_dequantization->positionScale);
+    shaderProgram.setUniform("u_uvOffset", m_dequantization->uvOffset);
+    shaderProgram.setUniform("u_uvScale", m_dequantization->uvScale);
+}
+
+void Engine::Renderer::Model::setInstanceBuffer(Buffer::Stream instanceBuffer, const uint32_t divisor) {
+    m_vertexArray.setInstanceBuffer(std::move(instanceBuffer), divisor);
 }
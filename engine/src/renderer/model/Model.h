@@ -1,5 +1,10 @@
 #pragma once
+#include <optional>
+
+#include "MeshCache.h"
 #include "MeshData.h"
+#include "VertexCompression.h"
+#include "../RenderQueue.h"
 #include "../Texture.h"
 #include "../VertexArray.h"
 
@@ -12,23 +17,80 @@ namespace Engine::Renderer {
     public:
         static Model generate(const MeshData& meshData, std::vector<Texture> textures = {});
 
-        void draw(const Shader::Program& shaderProgram) const;
+        static Model generate(const CookedMesh& cookedMesh, std::vector<Texture> textures = {});
+
+        // Uploads the mesh in the 14 byte VertexCompression format, draw it with a shader including Dequantize.glsl
+        static Model generateCompressed(const MeshData& meshData, std::vector<Texture> textures = {});
+
+        static Model generateCompressed(const CookedMesh& cookedMesh, std::vector<Texture> textures = {});
+
+        // Largest on screen error, as a fraction of the screen height, a level may have to be selected
+        static constexpr float s_lodErrorThreshold{1.f / 1080.f};
+
+        void draw(const Shader::Program& shaderProgram, uint32_t lod = 0) const;
+
+        // Queues the level as one packet. The model fills in its vertex array, textures and index range, the rest of
+        // the packet is up to the caller.
+        void submit(RenderQueue& renderQueue, RenderQueue::Packet packet, uint32_t lod = 0) const;
+
+        void drawInstanced(const Shader::Program& shaderProgram, const void* instanceData, uint32_t instanceCount);
+
+        // Draws the instanceCount instances written into mapInstances()
+        void drawInstanced(const Shader::Program& shaderProgram, uint32_t instanceCount);
+
+        // Instance buffer memory to write this frame's instances into, without going through a copy
+        template<typename T>
+        [[nodiscard]] std::span<T> mapInstances(uint32_t instanceCount);
+
+        // Draws every instance with the level of detail given for it in instanceLods, one instanced draw per level
+        void drawInstancedLod(const Shader::Program& shaderProgram, const void* instanceData,
+                              std::span<const uint8_t> instanceLods);
 
-        void drawInstanced(const Shader::Program& shaderProgram, const void* instanceData,
-                           uint32_t instanceCount) const;
+        // Coarsest level whose error is below threshold at the given size, see Camera::projectedSize()
+        [[nodiscard]] uint8_t selectLod(float screenSize, float threshold = s_lodErrorThreshold) const;
 
-        void setInstanceBuffer(Buffer::Vertex instanceBuffer);
+        void setInstanceBuffer(Buffer::Stream instanceBuffer, uint32_t divisor = 1);
+
+        // Sets the Dequantize.glsl uniforms, the program has to be bound
+        void applyDequantization(const Shader::Program& shaderProgram) const;
+
+        [[nodiscard]] bool isCompressed() const {
+            return m_dequantization.has_value();
+        }
 
         const auto& getTextures() const {
             return m_textures;
         }
 
+        [[nodiscard]] const std::vector<MeshData::Lod>& getLods() const {
+            return m_lods;
+        }
+
+        [[nodiscard]] const MeshData::Bounds& getBounds() const {
+            return m_bounds;
+        }
+
     private:
-        explicit Model::Model(VertexArray vao, std::vector<Texture> textures = {}) : m_vertexArray(std::move(vao)),
-            m_textures(std::move(textures)) {
+        explicit Model::Model(VertexArray vao, std::vector<MeshData::Lod> lods, const MeshData::Bounds& bounds,
+                              std::vector<Texture> textures = {},
+                              const std::optional<VertexCompression::Dequantization>& dequantization = {})
+            : m_vertexArray(std::move(vao)), m_textures(std::move(textures)), m_lods(std::move(lods)),
+              m_bounds{bounds}, m_dequantization{dequantization} {
         }
 
         VertexArray m_vertexArray;
         std::vector<Texture> m_textures;
+        std::vector<MeshData::Lod> m_lods;
+        MeshData::Bounds m_bounds;
+        std::optional<VertexCompression::Dequantization> m_dequantization;
     };
+
+    template<typename T>
+    std::span<T> Model::mapInstances(const uint32_t instanceCount) {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        ASSERT(m_vertexArray.getInstanceBuffer().getLayout().getStride() == sizeof(T));
+
+        const auto instances = m_vertexArray.mapInstances(instanceCount);
+        return {reinterpret_cast<T*>(instances.data()), instanceCount};
+    }
 }
@@ -2,21 +2,32 @@
 
 #include <fstream>
 #include <iomanip>
-#include <optional>
 #include <array>
-#include <unordered_map>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <thread>
 
 #include "core/Assert.h"
 #include "core/StringUtils.h"
 
 using MeshData = Engine::Renderer::MeshData;
 using ObjParser = Engine::Renderer::ObjParser;
+using VertexDedupTable = Engine::Renderer::VertexDedupTable;
 
-Engine::Renderer::ObjParser::ObjParser(const std::string& path) : m_file(path) {
+Engine::Renderer::ObjParser::ObjParser(const std::string& path, const Mode mode) : m_mode{mode} {
     ASSERT_MSG(path.ends_with(".obj"),
                "In Engine::Renderer::Model::loadObjModel(): File is not of supported type '.obj': " << path);
-    ASSERT_MSG(m_file.is_open(),
-               "In Engine::Renderer::Model::loadObjModel(): Could not open file with path: " << path);
+
+    if (m_mode == Mode::STREAM) {
+        m_file.open(path);
+        ASSERT_MSG(m_file.is_open(),
+                   "In Engine::Renderer::Model::loadObjModel(): Could not open file with path: " << path);
+    } else {
+        m_mappedFile = MappedFile{path};
+        ASSERT_MSG(m_mappedFile.isOpen(),
+                   "In Engine::Renderer::Model::loadObjModel(): Could not open file with path: " << path);
+    }
 }
 
 template<typename T, typename = std::enable_if_t<std::is_same_v<T, glm::vec2> || std::is_same_v<T, glm::vec3>> >
@@ -48,31 +59,7 @@ static bool matchAndAdvance(auto& it, const auto& end, const std::string& token)
     return false;
 }
 
-struct VertexKey {
-    bool operator==(const VertexKey& other) const noexcept {
-        return posIdx == other.posIdx &&
-               texIdx == other.texIdx &&
-               normIdx == other.normIdx;
-    }
-
-    struct Hash {
-        std::size_t operator()(const VertexKey& k) const noexcept {
-            auto h = std::hash<uint32_t>{}(k.posIdx);
-            if (k.texIdx) {
-                h ^= std::hash<uint32_t>{}(*k.texIdx + 1);
-            }
-
-            if (k.normIdx) {
-                h ^= std::hash<uint32_t>{}(*k.normIdx + 2);
-            }
-            return h;
-        }
-    };
-
-    uint32_t posIdx;
-    std::optional<uint32_t> texIdx;
-    std::optional<uint32_t> normIdx;
-};
+using VertexKey = Engine::Renderer::VertexDedupTable::Key;
 
 // Apparently you may need to account for negative indices which mean an index previous to the latest
 static uint32_t rebase_index(const int i, const size_t n) {
@@ -116,30 +103,40 @@ static VertexKey parseFaceElement(std::string_view elem,
 }
 
 
-uint32_t getOrCreateVertex(const VertexKey& key,
+static uint32_t getOrCreateVertex(const VertexKey& key,
                            MeshData& mesh,
-                           std::unordered_map<VertexKey, uint32_t, VertexKey::Hash>& vertexMap,
+                           VertexDedupTable& vertexTable,
                            const std::vector<glm::vec3>& rawPositions,
                            const std::vector<glm::vec2>& rawTexCoords,
                            const std::vector<glm::vec3>& rawNormals) {
-    auto [it, inserted] = vertexMap.try_emplace(key, static_cast<uint32_t>(mesh.positions.size()));
+    const auto [index, inserted] = vertexTable.findOrInsert(key, static_cast<uint32_t>(mesh.positions.size()));
     if (inserted) {
         mesh.positions.emplace_back(rawPositions[key.posIdx]);
         // Keep arrays aligned
-        mesh.textureCoords.emplace_back(key.texIdx ? rawTexCoords[*key.texIdx] : glm::vec2(0.0f));
-        mesh.normals.emplace_back(key.normIdx ? rawNormals[*key.normIdx] : glm::vec3(0.0f));
+        mesh.textureCoords.emplace_back(key.hasTexCoord() ? rawTexCoords[key.texIdx] : glm::vec2(0.0f));
+        mesh.normals.emplace_back(key.hasNormal() ? rawNormals[key.normIdx] : glm::vec3(0.0f));
     }
-    return it->second;
+    return index;
 }
 
 
 MeshData ObjParser::operator()() {
+    switch (m_mode) {
+        case Mode::STREAM: return parseStream();
+        case Mode::MAPPED: return parseMapped();
+        case Mode::PARALLEL: return parseParallel();
+    }
+
+    std::unreachable();
+}
+
+MeshData ObjParser::parseStream() {
     std::vector<glm::vec3> rawPositions;
     std::vector<glm::vec2> rawTexCoords;
     std::vector<glm::vec3> rawNormals;
 
     MeshData meshData;
-    std::unordered_map<VertexKey, uint32_t, VertexKey::Hash> vertexMap;
+    VertexDedupTable vertexTable;
 
     std::string line;
     while (std::getline(m_file, line)) {
@@ -160,7 +157,7 @@ MeshData ObjParser::operator()() {
             std::vector<uint32_t> face;
             for (; it != tokens.end(); ++it) {
                 const auto key = parseFaceElement(*it, rawPositions.size(), rawTexCoords.size(), rawNormals.size());
-                face.push_back(getOrCreateVertex(key, meshData, vertexMap, rawPositions, rawTexCoords, rawNormals));
+                face.push_back(getOrCreateVertex(key, meshData, vertexTable, rawPositions, rawTexCoords, rawNormals));
             }
 
             // triangulate: (0, i-1, i)
@@ -172,5 +169,497 @@ MeshData ObjParser::operator()() {
         }
     }
 
+    m_dedupStats = vertexTable.getStats();
+    return meshData;
+}
+
+// The mapped path walks the file bytes in place. It must produce exactly what the stream path produces, so the
+// whitespace set matches tokenize() and malformed numbers fall back to std::from_chars on the same bytes.
+namespace {
+    constexpr bool isSeparator(const char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v' || c == ';';
+    }
+
+    constexpr bool isDigit(const char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    const char* skipSeparators(const char* it, const char* end) {
+        while (it < end && isSeparator(*it)) {
+            ++it;
+        }
+
+        return it;
+    }
+
+    const char* findSeparator(const char* it, const char* end) {
+        while (it < end && !isSeparator(*it)) {
+            ++it;
+        }
+
+        return it;
+    }
+
+    bool tokenEquals(const char* begin, const char* end, const std::string_view token) {
+        return static_cast<size_t>(end - begin) == token.size() && std::equal(begin, end, token.begin());
+    }
+
+    constexpr std::array<float, 11> s_powersOf10{1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+
+    // Exact when the mantissa fits in a float and the power of ten is exactly representable (Clinger's fast path).
+    // Everything else is handed to std::from_chars, which is correctly rounded but slower.
+    float scanFloat(const char* begin, const char* end) {
+        const char* it = begin;
+        const bool negative = it < end && *it == '-';
+        if (negative) {
+            ++it;
+        }
+
+        uint64_t mantissa{};
+        int exponent{};
+        int digits{};
+        bool anyDigits{};
+
+        for (; it < end && isDigit(*it); ++it) {
+            anyDigits = true;
+            if (mantissa != 0 || *it != '0') {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*it - '0');
+                digits++;
+            }
+        }
+
+        if (it < end && *it == '.') {
+            ++it;
+            for (; it < end && isDigit(*it); ++it) {
+                anyDigits = true;
+                if (mantissa != 0 || *it != '0') {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*it - '0');
+                    digits++;
+                }
+                exponent--;
+            }
+        }
+
+        if (it < end && (*it == 'e' || *it == 'E')) {
+            const char* expIt = it + 1;
+            const bool expNegative = expIt < end && *expIt == '-';
+            if (expIt < end && (*expIt == '-' || *expIt == '+')) {
+                ++expIt;
+            }
+
+            // An exponent without digits is not part of the number, same as from_chars
+            if (expIt < end && isDigit(*expIt)) {
+                int expValue{};
+                for (; expIt < end && isDigit(*expIt); ++expIt) {
+                    expValue = std::min(expValue * 10 + (*expIt - '0'), 10000);
+                }
+                exponent += expNegative ? -expValue : expValue;
+            }
+        }
+
+        while (mantissa != 0 && mantissa % 10 == 0) {
+            mantissa /= 10;
+            exponent++;
+        }
+
+        if (anyDigits && digits <= 19 && mantissa <= (uint64_t{1} << 24) && exponent >= -10 && exponent <= 10) {
+            auto value = static_cast<float>(mantissa);
+            value = exponent < 0
+                        ? value / s_powersOf10[static_cast<size_t>(-exponent)]
+                        : value * s_powersOf10[static_cast<size_t>(exponent)];
+            return negative ? -value : value;
+        }
+
+        float value{};
+        [[maybe_unused]] const auto res = std::from_chars(begin, end, value);
+        ASSERT_MSG(res.ec == std::errc(), "Malformed float: " << std::string_view(begin, end));
+        return value;
+    }
+
+    int scanInt(const char* begin, const char* end) {
+        const char* it = begin;
+        const bool negative = it < end && *it == '-';
+        if (negative) {
+            ++it;
+        }
+
+        int64_t value{};
+        const char* digitsBegin = it;
+        for (; it < end && isDigit(*it) && it - digitsBegin < 10; ++it) {
+            value = value * 10 + (*it - '0');
+        }
+
+        value = negative ? -value : value;
+        if (it == digitsBegin || (it < end && isDigit(*it)) || value > std::numeric_limits<int>::max() ||
+            value < std::numeric_limits<int>::min()) {
+            int fallback{};
+            [[maybe_unused]] auto [ptr, ec] = std::from_chars(begin, end, fallback);
+            ASSERT_MSG(ec == std::errc(), "Malformed integer in face element");
+            return fallback;
+        }
+
+        return static_cast<int>(value);
+    }
+
+    template<typename T>
+    T scanVec(const char*& it, const char* end) {
+        T vec{};
+
+        for (glm::length_t i{}; i < T::length(); i++) {
+            it = skipSeparators(it, end);
+            if (it >= end) {
+                break;
+            }
+
+            const char* tokenEnd = findSeparator(it, end);
+            vec[i] = scanFloat(it, tokenEnd);
+            it = tokenEnd;
+        }
+
+        return vec;
+    }
+
+    // Face element indices exactly as written in the file, before rebasing. OBJ indices are never 0.
+    struct RawFaceElement {
+        int posIdx;
+        int texIdx;
+        int normIdx;
+    };
+
+    RawFaceElement scanFaceElement(const char* begin, const char* end) {
+        RawFaceElement element{};
+        const auto* firstSlash = std::find(begin, end, '/');
+        const auto* secondSlash = firstSlash == end ? end : std::find(firstSlash + 1, end, '/');
+
+        // v
+        element.posIdx = scanInt(begin, firstSlash);
+
+        // vt
+        if (firstSlash != end && secondSlash > firstSlash + 1) {
+            element.texIdx = scanInt(firstSlash + 1, secondSlash);
+        }
+
+        // vn
+        if (secondSlash != end && secondSlash + 1 < end) {
+            element.normIdx = scanInt(secondSlash + 1, end);
+        }
+
+        return element;
+    }
+
+    template<typename Func>
+    void forEachFaceElement(const char* it, const char* lineEnd, Func&& func) {
+        it = skipSeparators(it, lineEnd);
+        while (it < lineEnd) {
+            const char* const elementEnd = findSeparator(it, lineEnd);
+            func(scanFaceElement(it, elementEnd));
+            it = skipSeparators(elementEnd, lineEnd);
+        }
+    }
+
+    // Walks the v/vt/vn/f records in [it, end). The handler receives the parsed vectors and, for faces, the
+    // remainder of the line.
+    template<typename Handler>
+    void scanRecords(const char* it, const char* const end, Handler& handler) {
+        while (it < end) {
+            const auto* newline = static_cast<const char*>(std::memchr(it, '\n', static_cast<size_t>(end - it)));
+            const char* const nextLine = newline == nullptr ? end : newline + 1;
+            const char* lineEnd = newline == nullptr ? end : newline;
+
+            if (const auto* comment = static_cast<const char*>(std::memchr(it, '#', static_cast<size_t>(lineEnd - it)));
+                comment != nullptr) {
+                lineEnd = comment;
+            }
+
+            it = skipSeparators(it, lineEnd);
+            const char* keywordEnd = findSeparator(it, lineEnd);
+
+            if (tokenEquals(it, keywordEnd, "v")) {
+                handler.position(scanVec<glm::vec3>(keywordEnd, lineEnd));
+            } else if (tokenEquals(it, keywordEnd, "vt")) {
+                handler.texCoord(scanVec<glm::vec2>(keywordEnd, lineEnd));
+            } else if (tokenEquals(it, keywordEnd, "vn")) {
+                handler.normal(scanVec<glm::vec3>(keywordEnd, lineEnd));
+            } else if (tokenEquals(it, keywordEnd, "f")) {
+                handler.face(keywordEnd, lineEnd);
+            }
+
+            it = nextLine;
+        }
+    }
+
+    void triangulate(const std::vector<uint32_t>& face, std::vector<uint32_t>& indices) {
+        // triangulate: (0, i-1, i)
+        for (size_t i = 2; i < face.size(); ++i) {
+            indices.push_back(face[0]);
+            indices.push_back(face[i - 1]);
+            indices.push_back(face[i]);
+        }
+    }
+
+    class SerialHandler {
+    public:
+        void position(const glm::vec3& position) {
+            m_rawPositions.emplace_back(position);
+        }
+
+        void texCoord(const glm::vec2& texCoord) {
+            m_rawTexCoords.emplace_back(texCoord);
+        }
+
+        void normal(const glm::vec3& normal) {
+            m_rawNormals.emplace_back(normal);
+        }
+
+        void face(const char* it, const char* lineEnd) {
+            m_face.clear();
+            forEachFaceElement(it, lineEnd, [this](const RawFaceElement& element) {
+                VertexKey key{};
+                key.posIdx = rebase_index(element.posIdx, m_rawPositions.size());
+                if (element.texIdx != 0) {
+                    key.texIdx = rebase_index(element.texIdx, m_rawTexCoords.size());
+                }
+
+                if (element.normIdx != 0) {
+                    key.normIdx = rebase_index(element.normIdx, m_rawNormals.size());
+                }
+
+                m_face.push_back(getOrCreateVertex(key, m_meshData, m_vertexTable, m_rawPositions, m_rawTexCoords,
+                                                   m_rawNormals));
+            });
+
+            triangulate(m_face, m_meshData.indices);
+        }
+
+        MeshData takeMeshData() {
+            return std::move(m_meshData);
+        }
+
+        [[nodiscard]] VertexDedupTable::Stats getDedupStats() const {
+            return m_vertexTable.getStats();
+        }
+
+    private:
+        std::vector<glm::vec3> m_rawPositions;
+        std::vector<glm::vec2> m_rawTexCoords;
+        std::vector<glm::vec3> m_rawNormals;
+
+        MeshData m_meshData;
+        VertexDedupTable m_vertexTable;
+        std::vector<uint32_t> m_face; // Reused between lines so faces don't allocate once it has grown
+    };
+
+    // Parses one newline aligned slice of the file. Indices that are already global (positive) are kept as they
+    // are. Negative indices are stored relative to the chunk's own attribute counts, since the counts of the
+    // chunks before it are not known until every worker is done.
+    class ChunkHandler {
+    public:
+        struct Element {
+            enum Flags : uint8_t {
+                HAS_TEX = 1 << 0,
+                HAS_NORM = 1 << 1,
+                POS_RELATIVE = 1 << 2,
+                TEX_RELATIVE = 1 << 3,
+                NORM_RELATIVE = 1 << 4
+            };
+
+            int posIdx;
+            int texIdx;
+            int normIdx;
+            uint8_t flags;
+        };
+
+        void position(const glm::vec3& position) {
+            positions.emplace_back(position);
+        }
+
+        void texCoord(const glm::vec2& texCoord) {
+            texCoords.emplace_back(texCoord);
+        }
+
+        void normal(const glm::vec3& normal) {
+            normals.emplace_back(normal);
+        }
+
+        void face(const char* it, const char* lineEnd) {
+            uint32_t faceSize{};
+            forEachFaceElement(it, lineEnd, [this, &faceSize](const RawFaceElement& raw) {
+                Element element{};
+                element.posIdx = localIndex(raw.posIdx, positions.size(), element.flags, Element::POS_RELATIVE);
+
+                if (raw.texIdx != 0) {
+                    element.flags |= Element::HAS_TEX;
+                    element.texIdx = localIndex(raw.texIdx, texCoords.size(), element.flags, Element::TEX_RELATIVE);
+                }
+
+                if (raw.normIdx != 0) {
+                    element.flags |= Element::HAS_NORM;
+                    element.normIdx = localIndex(raw.normIdx, normals.size(), element.flags, Element::NORM_RELATIVE);
+                }
+
+                elements.push_back(element);
+                faceSize++;
+            });
+
+            faceSizes.push_back(faceSize);
+        }
+
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texCoords;
+        std::vector<glm::vec3> normals;
+        std::vector<Element> elements;
+        std::vector<uint32_t> faceSizes;
+
+    private:
+        static int localIndex(const int i, const size_t localCount, uint8_t& flags, const uint8_t relativeFlag) {
+            if (i > 0) {
+                return i - 1;
+            }
+
+            // May end up negative, which means it points into an earlier chunk
+            flags |= relativeFlag;
+            return static_cast<int>(localCount) + i;
+        }
+    };
+
+    // Resolves a chunk element index against the attribute count of every chunk before it
+    uint32_t resolveIndex(const int idx, const bool relative, const size_t base, const size_t total) {
+        const int64_t resolved = relative ? static_cast<int64_t>(base) + idx : idx;
+        ASSERT_MSG(resolved >= 0 && std::cmp_less(resolved, total), "Index out of range");
+        return static_cast<uint32_t>(resolved);
+    }
+
+    std::vector<std::string_view> splitIntoChunks(const std::string_view file, const size_t chunkCount) {
+        std::vector<std::string_view> chunks;
+        chunks.reserve(chunkCount);
+
+        size_t begin{};
+        for (size_t i{1}; i <= chunkCount && begin < file.size(); i++) {
+            size_t end = i == chunkCount ? file.size() : std::max(begin, file.size() * i / chunkCount);
+            if (end < file.size()) {
+                const auto newline = file.find('\n', end);
+                end = newline == std::string_view::npos ? file.size() : newline + 1;
+            }
+
+            chunks.emplace_back(file.substr(begin, end - begin));
+            begin = end;
+        }
+
+        return chunks;
+    }
+}
+
+MeshData ObjParser::parseMapped() {
+    if (m_mappedConsumed) {
+        return MeshData{};
+    }
+
+    m_mappedConsumed = true;
+
+    SerialHandler handler;
+    scanRecords(m_mappedFile.data(), m_mappedFile.data() + m_mappedFile.size(), handler);
+    m_dedupStats = handler.getDedupStats();
+    return handler.takeMeshData();
+}
+
+MeshData ObjParser::parseParallel() {
+    if (m_mappedConsumed) {
+        return MeshData{};
+    }
+
+    const size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    const size_t chunkCount = std::min(threadCount, m_mappedFile.size() / s_minChunkSize);
+
+    if (chunkCount <= 1) {
+        return parseMapped();
+    }
+
+    m_mappedConsumed = true;
+
+    const auto chunkViews = splitIntoChunks(m_mappedFile.view(), chunkCount);
+    std::vector<ChunkHandler> chunks(chunkViews.size());
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(chunkViews.size());
+        for (size_t i{}; i < chunkViews.size(); i++) {
+            workers.emplace_back([&chunk = chunks[i], view = chunkViews[i]] {
+                scanRecords(view.data(), view.data() + view.size(), chunk);
+            });
+        }
+    }
+
+    // Merge in file order so vertices are created in the same order the serial parser creates them
+    std::vector<glm::vec3> rawPositions;
+    std::vector<glm::vec2> rawTexCoords;
+    std::vector<glm::vec3> rawNormals;
+    size_t elementCount{};
+    {
+        size_t posCount{};
+        size_t texCount{};
+        size_t normCount{};
+        for (const auto& chunk: chunks) {
+            posCount += chunk.positions.size();
+            texCount += chunk.texCoords.size();
+            normCount += chunk.normals.size();
+            elementCount += chunk.elements.size();
+        }
+
+        rawPositions.reserve(posCount);
+        rawTexCoords.reserve(texCount);
+        rawNormals.reserve(normCount);
+    }
+
+    std::vector<size_t> posBases;
+    std::vector<size_t> texBases;
+    std::vector<size_t> normBases;
+    for (const auto& chunk: chunks) {
+        posBases.push_back(rawPositions.size());
+        texBases.push_back(rawTexCoords.size());
+        normBases.push_back(rawNormals.size());
+        rawPositions.insert(rawPositions.end(), chunk.positions.begin(), chunk.positions.end());
+        rawTexCoords.insert(rawTexCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+        rawNormals.insert(rawNormals.end(), chunk.normals.begin(), chunk.normals.end());
+    }
+
+    MeshData meshData;
+    meshData.indices.reserve(elementCount * 3 / 2);
+
+    // Every face element is at most one new vertex. Meshes rarely have many more vertices than their largest
+    // attribute array though, so don't reserve for the worst case
+    const size_t maxAttributeCount = std::max({rawPositions.size(), rawTexCoords.size(), rawNormals.size()});
+    VertexDedupTable vertexTable{std::min(elementCount, maxAttributeCount + maxAttributeCount / 2)};
+    std::vector<uint32_t> face;
+
+    using Element = ChunkHandler::Element;
+    for (size_t c{}; c < chunks.size(); c++) {
+        const auto& chunk = chunks[c];
+        auto elementIt = chunk.elements.begin();
+
+        for (const uint32_t faceSize: chunk.faceSizes) {
+            face.clear();
+            for (uint32_t i{}; i < faceSize; i++, ++elementIt) {
+                const Element& element = *elementIt;
+                VertexKey key{};
+                key.posIdx = resolveIndex(element.posIdx, element.flags & Element::POS_RELATIVE, posBases[c],
+                                          rawPositions.size());
+                if (element.flags & Element::HAS_TEX) {
+                    key.texIdx = resolveIndex(element.texIdx, element.flags & Element::TEX_RELATIVE, texBases[c],
+                                              rawTexCoords.size());
+                }
+
+                if (element.flags & Element::HAS_NORM) {
+                    key.normIdx = resolveIndex(element.normIdx, element.flags & Element::NORM_RELATIVE, normBases[c],
+                                               rawNormals.size());
+                }
+
+                face.push_back(getOrCreateVertex(key, meshData, vertexTable, rawPositions, rawTexCoords, rawNormals));
+            }
+
+            triangulate(face, meshData.indices);
+        }
+    }
+
+    m_dedupStats = vertexTable.getStats();
     return meshData;
 }
@@ -4,11 +4,19 @@
 #include <string>
 
 #include "MeshData.h"
+#include "VertexDedupTable.h"
+#include "core/MappedFile.h"
 
 namespace Engine::Renderer {
     class ObjParser {
     public:
-        explicit ObjParser(const std::string& path);
+        enum class Mode : uint8_t {
+            STREAM, // Line by line through std::getline
+            MAPPED, // Memory maps the file and scans the bytes in place
+            PARALLEL // Like MAPPED, but newline aligned chunks are scanned on worker threads and then merged
+        };
+
+        explicit ObjParser(const std::string& path, Mode mode = Mode::MAPPED);
 
         MeshData operator()();
 
@@ -16,7 +24,24 @@ namespace Engine::Renderer {
             return (*this)();
         }
 
+        // How the vertex dedup table behaved during the last parse
+        [[nodiscard]] const VertexDedupTable::Stats& getDedupStats() const {
+            return m_dedupStats;
+        }
+
     private:
+        MeshData parseStream();
+
+        MeshData parseMapped();
+
+        MeshData parseParallel();
+
+        static constexpr size_t s_minChunkSize{1 << 20};
+
+        Mode m_mode;
         std::ifstream m_file;
+        MappedFile m_mappedFile;
+        bool m_mappedConsumed{};
+        VertexDedupTable::Stats m_dedupStats;
     };
 }
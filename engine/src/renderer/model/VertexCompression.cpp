@@ -0,0 +1,100 @@
+#include "VertexCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+namespace {
+    template<typename T>
+    T quantizeUnorm(const float value) {
+        constexpr auto max = static_cast<float>(std::numeric_limits<T>::max());
+        return static_cast<T>(std::lround(std::clamp(value, 0.f, 1.f) * max));
+    }
+
+    template<typename T>
+    T quantizeSnorm(const float value) {
+        constexpr auto max = static_cast<float>(std::numeric_limits<T>::max());
+        return static_cast<T>(std::lround(std::clamp(value, -1.f, 1.f) * max));
+    }
+
+    // Range of a set of values as offset and scale. A flat axis gets a scale of 1 so dequantizing stays exact.
+    template<typename Vec>
+    void findRange(const std::vector<Vec>& values, Vec& offset, Vec& scale) {
+        if (values.empty()) {
+            offset = Vec{0.f};
+            scale = Vec{1.f};
+            return;
+        }
+
+        Vec min{values.front()};
+        Vec max{values.front()};
+        for (const auto& value: values) {
+            min = glm::min(min, value);
+            max = glm::max(max, value);
+        }
+
+        offset = min;
+        scale = max - min;
+        for (glm::length_t i{}; i < Vec::length(); i++) {
+            if (scale[i] <= 0.f) {
+                scale[i] = 1.f;
+            }
+        }
+    }
+}
+
+glm::vec2 Engine::Renderer::VertexCompression::octEncode(const glm::vec3& normal) {
+    const float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (l1 <= 0.f) {
+        return glm::vec2{0.f};
+    }
+
+    glm::vec2 encoded{normal.x / l1, normal.y / l1};
+    if (normal.z < 0.f) {
+        // Fold the lower hemisphere over the diagonals
+        encoded = glm::vec2{
+            (1.f - std::abs(encoded.y)) * (encoded.x >= 0.f ? 1.f : -1.f),
+            (1.f - std::abs(encoded.x)) * (encoded.y >= 0.f ? 1.f : -1.f)
+        };
+    }
+
+    return encoded;
+}
+
+glm::vec3 Engine::Renderer::VertexCompression::octDecode(const glm::vec2& encoded) {
+    glm::vec3 normal{encoded.x, encoded.y, 1.f - std::abs(encoded.x) - std::abs(encoded.y)};
+    const float t = std::max(-normal.z, 0.f);
+    normal.x += normal.x >= 0.f ? -t : t;
+    normal.y += normal.y >= 0.f ? -t : t;
+    return glm::normalize(normal);
+}
+
+std::vector<Engine::Renderer::VertexCompression::Vertex> Engine::Renderer::VertexCompression::compress(
+    const MeshData& meshData, Dequantization& dequantization) {
+    findRange(meshData.positions, dequantization.positionOffset, dequantization.positionScale);
+    findRange(meshData.textureCoords, dequantization.uvOffset, dequantization.uvScale);
+
+    std::vector<Vertex> vertices(meshData.positions.size());
+    for (size_t i{}; i < vertices.size(); i++) {
+        const glm::vec3 position = (meshData.positions[i] - dequantization.positionOffset) / dequantization.
+                                   positionScale;
+        vertices[i].position = glm::u16vec3{
+            quantizeUnorm<uint16_t>(position.x), quantizeUnorm<uint16_t>(position.y),
+            quantizeUnorm<uint16_t>(position.z)
+        };
+
+        if (i < meshData.textureCoords.size()) {
+            const glm::vec2 uv = (meshData.textureCoords[i] - dequantization.uvOffset) / dequantization.uvScale;
+            vertices[i].uv = glm::u16vec2{quantizeUnorm<uint16_t>(uv.x), quantizeUnorm<uint16_t>(uv.y)};
+        }
+
+        if (i < meshData.normals.size()) {
+            const glm::vec2 normal = octEncode(meshData.normals[i]);
+            vertices[i].normal = glm::i16vec2{quantizeSnorm<int16_t>(normal.x), quantizeSnorm<int16_t>(normal.y)};
+        }
+    }
+
+    return vertices;
+}
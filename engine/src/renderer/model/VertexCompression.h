@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/fwd.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "MeshData.h"
+
+// Opt-in 14 byte vertex format, down from the 32 bytes of MeshData::baseLayout():
+// - position: unorm16x3 inside the mesh bounding box
+// - uv: unorm16x2 inside the mesh uv range
+// - normal: octahedral encoded snorm16x2
+// Draw it with shader/source/Compressed.vert and set the Dequantization uniforms.
+namespace Engine::Renderer::VertexCompression {
+    struct Vertex {
+        glm::u16vec3 position;
+        glm::u16vec2 uv;
+        glm::i16vec2 normal;
+    };
+
+    static_assert(sizeof(Vertex) == 14);
+
+    // Turns the normalized attributes back into mesh space, value = offset + unorm * scale
+    struct Dequantization {
+        glm::vec3 positionOffset{};
+        glm::vec3 positionScale{1.f};
+        glm::vec2 uvOffset{};
+        glm::vec2 uvScale{1.f};
+    };
+
+    inline Buffer::Vertex::Layout layout() {
+        return Buffer::Vertex::Layout{
+            Buffer::Vertex::Layout::Attribute{Shader::DataType::UShort3, true},
+            Buffer::Vertex::Layout::Attribute{Shader::DataType::UShort2, true},
+            Buffer::Vertex::Layout::Attribute{Shader::DataType::Short2, true}
+        };
+    }
+
+    glm::vec2 octEncode(const glm::vec3& normal);
+
+    glm::vec3 octDecode(const glm::vec2& encoded);
+
+    std::vector<Vertex> compress(const MeshData& meshData, Dequantization& dequantization);
+}
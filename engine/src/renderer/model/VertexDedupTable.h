@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "core/Hash.h"
+
+namespace Engine::Renderer {
+    // Flat open addressing (linear probing) table from an OBJ face element to the vertex it was turned into.
+    // Slots are stored inline, so a lookup is one hash and usually a single cache line.
+    class VertexDedupTable {
+    public:
+        struct Key {
+            static constexpr uint32_t s_absent{std::numeric_limits<uint32_t>::max()};
+
+            bool operator==(const Key&) const = default;
+
+            [[nodiscard]] bool hasTexCoord() const {
+                return texIdx != s_absent;
+            }
+
+            [[nodiscard]] bool hasNormal() const {
+                return normIdx != s_absent;
+            }
+
+            uint32_t posIdx{};
+            uint32_t texIdx{s_absent};
+            uint32_t normIdx{s_absent};
+        };
+
+        struct Stats {
+            [[nodiscard]] double getLoadFactor() const {
+                return capacity == 0 ? 0.0 : static_cast<double>(size) / static_cast<double>(capacity);
+            }
+
+            [[nodiscard]] double getAverageProbeLength() const {
+                return lookups == 0 ? 0.0 : static_cast<double>(probes) / static_cast<double>(lookups);
+            }
+
+            size_t size{};
+            size_t capacity{};
+            size_t lookups{};
+            size_t probes{}; // Slots inspected over all lookups
+            size_t maxProbeLength{};
+            size_t rehashes{};
+        };
+
+        VertexDedupTable() = default;
+
+        explicit VertexDedupTable(const size_t expectedCount) {
+            reserve(expectedCount);
+        }
+
+        void reserve(const size_t count) {
+            const size_t capacity = std::bit_ceil(std::max<size_t>(s_minCapacity, count * s_maxLoadDen / s_maxLoadNum
+                                                                                  + 1));
+            if (capacity > m_slots.size()) {
+                rehash(capacity);
+            }
+        }
+
+        // Returns the vertex index stored for key, inserting value if the key is new
+        std::pair<uint32_t, bool> findOrInsert(const Key& key, const uint32_t value) {
+            if ((m_size + 1) * s_maxLoadDen > m_slots.size() * s_maxLoadNum) {
+                rehash(std::max(s_minCapacity, m_slots.size() * 2));
+            }
+
+            m_stats.lookups++;
+            size_t probeLength{1};
+            for (size_t i = hash(key) & m_mask;; i = (i + 1) & m_mask, probeLength++) {
+                Slot& slot = m_slots[i];
+                if (slot.value == s_emptyValue) {
+                    slot.key = key;
+                    slot.value = value;
+                    m_size++;
+                    recordProbe(probeLength);
+                    return {value, true};
+                }
+
+                if (slot.key == key) {
+                    recordProbe(probeLength);
+                    return {slot.value, false};
+                }
+            }
+        }
+
+        [[nodiscard]] size_t size() const {
+            return m_size;
+        }
+
+        [[nodiscard]] Stats getStats() const {
+            Stats stats = m_stats;
+            stats.size = m_size;
+            stats.capacity = m_slots.size();
+            return stats;
+        }
+
+    private:
+        struct Slot {
+            Key key;
+            uint32_t value{s_emptyValue};
+        };
+
+        static constexpr uint32_t s_emptyValue{std::numeric_limits<uint32_t>::max()};
+        static constexpr size_t s_minCapacity{16};
+        // Linear probing degrades quickly past ~75% full, so grow at 70%
+        static constexpr size_t s_maxLoadNum{7};
+        static constexpr size_t s_maxLoadDen{10};
+
+        static size_t hash(const Key& key) {
+            const uint64_t posTex = (static_cast<uint64_t>(key.texIdx) << 32) | key.posIdx;
+            return static_cast<size_t>(Hash::mix64(posTex ^ Hash::mix64(key.normIdx + 0x9e3779b97f4a7c15ull)));
+        }
+
+        void recordProbe(const size_t probeLength) {
+            m_stats.probes += probeLength;
+            m_stats.maxProbeLength = std::max(m_stats.maxProbeLength, probeLength);
+        }
+
+        void rehash(const size_t capacity) {
+            std::vector<Slot> old(capacity);
+            std::swap(old, m_slots);
+            m_mask = capacity - 1;
+            m_stats.rehashes += m_size > 0 ? 1 : 0;
+
+            for (const Slot& slot: old) {
+                if (slot.value == s_emptyValue) {
+                    continue;
+                }
+
+                size_t i = hash(slot.key) & m_mask;
+                while (m_slots[i].value != s_emptyValue) {
+                    i = (i + 1) & m_mask;
+                }
+                m_slots[i] = slot;
+            }
+        }
+
+        std::vector<Slot> m_slots;
+        size_t m_mask{};
+        size_t m_size{};
+        Stats m_stats;
+    };
+}
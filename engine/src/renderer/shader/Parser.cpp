@@ -1,11 +1,14 @@
-#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <optional>
 #include <unordered_map>
-#include <unordered_set>
+#include <vector>
 #include <glad/glad.h>
 
 #include "Parser.h"
 #include "core/Assert.h"
-#include "core/StringUtils.h"
+#include "core/MappedFile.h"
 
 namespace Shader = Engine::Renderer::Shader;
 
@@ -16,24 +19,179 @@ struct StringReplace {
 
 static constexpr StringReplace engineResPath{.from = "ENGINE_RES_PATH", .to = ENGINE_RES_PATH};
 
-Shader::Parser::ParseCache::~ParseCache() {
-    includedPaths.clear();
-    shaderStructs.clear();
+// Room for the includes on top of the stage itself, the output grows past it only for unusually large includes
+static constexpr size_t s_includeReserve{4096};
+
+static constexpr std::string_view s_whitespace{" \t\r\f\v;"};
+
+struct CachedFile {
+    std::filesystem::file_time_type mtime;
+    std::shared_ptr<const std::string> content;
+};
+
+// Shared by every parser. Only touched from the thread owning the GL context, like everything else shader related.
+static std::unordered_map<std::string, CachedFile> s_fileCache;
+
+static std::shared_ptr<const std::string> readFile(const std::string& path) {
+    std::error_code error;
+    const auto mtime = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return nullptr;
+    }
+
+    if (const auto it = s_fileCache.find(path); it != s_fileCache.end() && it->second.mtime == mtime) {
+        return it->second.content;
+    }
+
+    const Engine::MappedFile file{path};
+    if (!file.isOpen()) {
+        return nullptr;
+    }
+
+    // Parsers still reading the old content keep it alive through their own reference
+    auto content = std::make_shared<const std::string>(file.view());
+    s_fileCache.insert_or_assign(path, CachedFile{mtime, content});
+    return content;
+}
+
+// Cuts the next line out of text, without the line break
+static std::string_view nextLine(const std::string_view text, size_t& offset) {
+    const size_t lineEnd = std::min(text.find('\n', offset), text.size());
+    std::string_view line = text.substr(offset, lineEnd - offset);
+    offset = lineEnd + 1;
+
+    if (const auto commentStart = line.find("//"); commentStart != std::string_view::npos) {
+        line = line.substr(0, commentStart);
+    }
+
+    if (line.ends_with('\r')) {
+        line.remove_suffix(1);
+    }
+
+    return line;
+}
+
+struct Directive {
+    std::string_view name;
+    std::string_view argument;
+};
+
+// Any preprocessor line. Only #shader, #include and the conditionals on variant defines are handled here, everything
+// else goes to the compiler as is.
+static std::optional<Directive> toDirective(std::string_view line) {
+    line.remove_prefix(std::min(line.find_first_not_of(s_whitespace), line.size()));
+    if (!line.starts_with('#')) {
+        return std::nullopt;
+    }
+
+    const size_t nameEnd = std::min(line.find_first_of(s_whitespace), line.size());
+    Directive directive{.name = line.substr(0, nameEnd), .argument = {}};
+
+    line.remove_prefix(nameEnd);
+    line.remove_prefix(std::min(line.find_first_not_of(s_whitespace), line.size()));
+    directive.argument = line.substr(0, std::min(line.find_first_of(s_whitespace), line.size()));
+    return directive;
+}
+
+// Open #ifdef and #ifndef blocks of one file. Blocks on variant defines are resolved here so equal permutations give
+// equal sources, the others are left to the driver. Anything inside a dropped branch is dropped with it.
+class Conditionals {
+public:
+    explicit Conditionals(const Shader::VariantMask variant) : m_variant{variant} {
+    }
+
+    // Whether the line goes into the output, resolved conditionals never do
+    bool accept(const std::optional<Directive>& directive) {
+        if (!directive.has_value()) {
+            return isActive();
+        }
+
+        if (directive->name == "#ifdef" || directive->name == "#ifndef") {
+            const auto variant = Shader::toVariant(directive->argument);
+            if (!variant.has_value()) {
+                m_blocks.push_back(Block{.resolved = false, .active = true});
+                return isActive();
+            }
+
+            const bool defined = (m_variant & Shader::toMask(*variant)) != 0;
+            const bool active = defined == (directive->name == "#ifdef");
+            m_blocks.push_back(Block{.resolved = true, .active = active});
+            m_inactive += active ? 0 : 1;
+            return false;
+        }
+
+        if (directive->name == "#if") {
+            m_blocks.push_back(Block{.resolved = false, .active = true});
+            return isActive();
+        }
+
+        if (m_blocks.empty() || !m_blocks.back().resolved) {
+            if (directive->name == "#endif" && !m_blocks.empty()) {
+                m_blocks.pop_back();
+            }
+
+            return isActive();
+        }
+
+        auto& block = m_blocks.back();
+        if (directive->name == "#else") {
+            m_inactive += block.active ? 1 : -1;
+            block.active = !block.active;
+            return false;
+        }
+
+        if (directive->name == "#endif") {
+            m_inactive -= block.active ? 0 : 1;
+            m_blocks.pop_back();
+            return false;
+        }
+
+        if (directive->name == "#elif") {
+            LOG_ERR("#elif is not supported after #ifdef or #ifndef on a variant define\n");
+            return false;
+        }
+
+        return isActive();
+    }
+
+    [[nodiscard]] bool isBalanced() const {
+        return m_blocks.empty();
+    }
+
+private:
+    struct Block {
+        bool resolved;
+        bool active;
+    };
+
+    [[nodiscard]] bool isActive() const {
+        return m_inactive == 0;
+    }
+
+    Shader::VariantMask m_variant;
+    std::vector<Block> m_blocks;
+    int32_t m_inactive{};
+};
+
+static void appendLine(std::string& output, const std::string_view line) {
+    output += line;
+    output += '\n';
 }
 
-Shader::Parser::~Parser() {
-    m_istream.close();
+Shader::Parser::ParseCache::~ParseCache() {
+    includedPaths.clear();
 }
 
-Shader::Parser::Parser(const std::string& filePath, const std::shared_ptr<ParseCache>& parseCache) : m_filePath{
-        filePath
-    },
-    m_istream{filePath}, m_parseCache{parseCache} {
-    if (!m_istream.is_open()) {
+Shader::Parser::Parser(const std::string& filePath, const VariantMask variant,
+                       const std::shared_ptr<ParseCache>& parseCache) : m_filePath{filePath},
+                                                                        m_file{readFile(filePath)},
+                                                                        m_variant{variant},
+                                                                        m_parseCache{parseCache} {
+    if (m_file == nullptr) {
         LOG_ERR("Invalid shader source path: " << filePath << '\n');
     }
 
-    ASSERT(m_istream.is_open());
+    ASSERT(m_file != nullptr);
 
     m_parseCache->includedPaths.emplace(filePath);
 
@@ -44,13 +202,6 @@ Shader::Parser::Parser(const std::string& filePath, const std::shared_ptr<ParseC
     }
 }
 
-struct Token {
-    std::string_view name;
-    size_t lineIndex;
-};
-
-using Statement = std::vector<Token>;
-
 uint32_t toGlShaderType(const std::string_view& type) {
     if (type == "vertex") {
         return GL_VERTEX_SHADER;
@@ -63,174 +214,128 @@ uint32_t toGlShaderType(const std::string_view& type) {
     return {};
 }
 
-static void findAndReplace(std::string& str, const std::string& toFind, const std::string& toReplace) {
-    Engine::size_type pos = str.find(toFind);
-    while (pos != std::string::npos) {
-        str.replace(pos, toFind.size(), toReplace);
-        pos = str.find(toFind);
-    }
-}
-
 void Shader::Parser::logParseFail(const size_t lineNbr, const std::string_view lineStr,
                                   const std::string& description) const {
     LOG_ERR("Failed to parse shader source: " << description << "Inside file: " << m_filePath << ". At line "
         << lineNbr << ". [LINE SOURCE]: " << lineStr << '\n');
 }
 
-template<typename... Args>
-static void findAndRemoveTokens(std::string& line, Args&&... tokens) {
-    (findAndReplace(line, std::forward<Args>(tokens), ""), ...);
+Shader::Source Shader::Parser::buildSource(const uint32_t shaderType, std::string sourceString) const {
+    return Source{shaderType, std::move(sourceString)};
 }
 
-Shader::Source Shader::Parser::buildSource(const uint32_t shaderType, const std::string& sourceString,
-                                           const std::vector<Uniform>& uniforms) const {
-    return Source{shaderType, sourceString, uniforms};
-}
-
-class LineStream {
-public:
-    void operator<<(const std::string& line) {
-        resultStream << line;
-        m_lineNbr++;
+void Shader::Parser::appendInclude(const std::string_view includeToken, std::string& output,
+                                   const size_t lineNbr) const {
+    std::string includePath{includeToken};
+    if (includePath.starts_with(engineResPath.from)) {
+        includePath.replace(0, std::strlen(engineResPath.from), engineResPath.to);
     }
 
-    [[nodiscard]] const std::stringstream& getResult() const {
-        return resultStream;
+    // Also breaks include cycles
+    if (!m_parseCache->includedPaths.emplace(includePath).second) {
+        return;
     }
 
-    [[nodiscard]] size_t getLineNbr() const {
-        return m_lineNbr;
+    const auto file = readFile(includePath);
+    if (file == nullptr) {
+        logParseFail(lineNbr, includeToken, "Invalid include path. ");
+        return;
     }
 
-private:
-    std::stringstream resultStream;
-    size_t m_lineNbr{1};
-};
-
-Shader::Source Shader::Parser::operator()() {
-    std::string line;
-    LineStream lineStream;
-
-    uint32_t shaderType{m_nextShaderType};
-    std::vector<Uniform> uniforms;
-    std::string shaderStructTypeName;
-
-    while (std::getline(m_istream, line)) {
-        removeLineComment(line, "//");
+    const std::string_view text{*file};
+    Conditionals conditionals{m_variant};
+    size_t offset{};
+    size_t includeLineNbr{};
+    while (offset < text.size()) {
+        const auto line = nextLine(text, offset);
+        includeLineNbr++;
         if (line.empty()) {
             continue;
         }
 
-        if (!shaderStructTypeName.empty()) {
-            const auto tokens{tokenize(line, " \t\n\f\v")};
-
-            auto it = tokens.begin();
-            while (it != tokens.end()) {
-                if (it->contains('}')) {
-                    shaderStructTypeName = "";
-                    break;
-                }
-
-                if (it->ends_with(';')) {
-                    const auto trimmedToken = it->substr(0, it->find_first_of(';'));
-                    m_parseCache->shaderStructs[shaderStructTypeName].emplace_back(trimmedToken);
-
-                    ++it;
-                    continue;
-                }
-
-                if (const auto nextIt = it + 1; nextIt != tokens.end() && nextIt->starts_with(';')) {
-                    m_parseCache->shaderStructs[shaderStructTypeName].emplace_back(*it);
-                }
-
-                ++it;
-            }
-        }
-
-        const auto tokens{tokenize(line)};
-
-        if (tokens.size() <= 1) {
-            lineStream << line + '\n';
+        const auto directive = toDirective(line);
+        if (!conditionals.accept(directive)) {
             continue;
         }
 
-        for (size_t i{}; i < tokens.size() - 1; i++) {
-            const auto token = tokens[i];
-
-            if (token == "uniform") {
-                if (i + 2 >= tokens.size()) {
-                    logParseFail(lineStream.getLineNbr(), line,
-                                 "Incomplete uniform declaration. Uniform name not found.");
-                }
-
-                const auto uniformType{std::string{tokens[i + 1]}};
-                const auto uniformName{std::string{tokens[i + 2]}};
+        if (!directive.has_value() || (directive->name != "#include" && directive->name != "#shader")) {
+            appendLine(output, line);
+        } else if (directive->name == "#include") {
+            appendInclude(directive->argument, output, includeLineNbr);
+        } else {
+            LOG_ERR("Failed to parse shader source: #shader inside an included file. Inside file: " << includePath
+                << ". At line " << includeLineNbr << '\n');
+        }
+    }
 
-                if (m_parseCache->shaderStructs.contains(uniformType)) {
-                    for (const auto& memberName: m_parseCache->shaderStructs[uniformType]) {
-                        uniforms.emplace_back(uniformName + "." + memberName);
-                    }
-                } else {
-                    uniforms.emplace_back(uniformName);
-                }
-                continue;
-            }
+    if (!conditionals.isBalanced()) {
+        LOG_ERR("Unterminated #ifdef or #ifndef. Inside file: " << includePath << '\n');
+    }
+}
 
-            if (token == "#include") {
-                const auto nextTokenCopy{std::string{tokens[i + 1]}};
+Shader::Source Shader::Parser::operator()() {
+    if (m_file == nullptr) {
+        return Source{};
+    }
 
-                if (m_parseCache->includedPaths.contains(nextTokenCopy)) {
-                    findAndRemoveTokens(line, std::string{token}, nextTokenCopy);
-                    continue;
-                }
+    const std::string_view text{*m_file};
+    std::string output;
+    output.reserve(text.size() - std::min(m_offset, text.size()) + s_includeReserve);
 
-                auto includePath{nextTokenCopy};
-                if (includePath.starts_with(engineResPath.from)) {
-                    includePath.replace(0, std::strlen(engineResPath.from), engineResPath.to);
-                }
+    uint32_t shaderType{m_nextShaderType};
+    // A stage ends at the next #shader, blocks can not span stages
+    Conditionals conditionals{m_variant};
 
-                Parser includeParser{includePath, m_parseCache};
-                while (const auto source{includeParser.next()}) {
-                    lineStream << source.getSource();
-                    uniforms.insert(uniforms.end(), source.getUniforms().begin(), source.getUniforms().end());
-                }
+    while (m_offset < text.size()) {
+        const auto line = nextLine(text, m_offset);
+        m_lineNbr++;
+        if (line.empty()) {
+            continue;
+        }
 
-                findAndRemoveTokens(line, std::string{token}, nextTokenCopy);
-                continue;
-            }
+        const auto directive = toDirective(line);
+        if (!conditionals.accept(directive)) {
+            continue;
+        }
 
-            if (token == "#shader") {
-                const auto nextTokenCopy{std::string{tokens[i + 1]}};
+        if (!directive.has_value() || (directive->name != "#include" && directive->name != "#shader")) {
+            appendLine(output, line);
+            continue;
+        }
 
-                if (shaderType != Source::s_shaderHeader) {
-                    m_nextShaderType = toGlShaderType(nextTokenCopy);
-                    LOG(lineStream.getResult().str());
-                    return buildSource(shaderType, lineStream.getResult().str(), uniforms);
-                }
+        if (directive->name == "#include") {
+            appendInclude(directive->argument, output, m_lineNbr);
+            continue;
+        }
 
-                shaderType = toGlShaderType(nextTokenCopy);
+        if (!conditionals.isBalanced()) {
+            logParseFail(m_lineNbr, line, "Unterminated #ifdef or #ifndef before #shader. ");
+        }
 
-                if (shaderType == Source::s_shaderHeader) {
-                    logParseFail(lineStream.getLineNbr(), line,
-                                 "Shader type evaluated to 0 (shader header), which is not a compilable shader type. ");
-                    return Source{};
-                }
+        if (shaderType != Source::s_shaderHeader) {
+            m_nextShaderType = toGlShaderType(directive->argument);
+            // Every stage compiles on its own, so it needs its own copy of the includes
+            m_parseCache->includedPaths = {m_filePath};
+            LOG(output);
+            return buildSource(shaderType, std::move(output));
+        }
 
-                findAndRemoveTokens(line, std::string{token}, nextTokenCopy);
-                continue;
-            }
+        shaderType = toGlShaderType(directive->argument);
 
-            if (token == "struct") {
-                shaderStructTypeName = std::string{tokens[i + 1]};
-            }
+        if (shaderType == Source::s_shaderHeader) {
+            logParseFail(m_lineNbr, line,
+                         "Shader type evaluated to 0 (shader header), which is not a compilable shader type. ");
+            return Source{};
         }
+    }
 
-        lineStream << line + '\n';
+    if (!conditionals.isBalanced()) {
+        LOG_ERR("Unterminated #ifdef or #ifndef. Inside file: " << m_filePath << '\n');
     }
 
     if (shaderType != Source::s_shaderHeader) {
-        LOG(lineStream.getResult().str());
+        LOG(output);
     }
 
-    return buildSource(shaderType, lineStream.getResult().str(), uniforms);
+    return buildSource(shaderType, std::move(output));
 }
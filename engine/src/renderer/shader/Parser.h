@@ -1,14 +1,16 @@
 #pragma once
 
-#include <fstream>
+#include <memory>
+#include <string_view>
 #include <unordered_set>
-#include <unordered_map>
 #include "Source.h"
+#include "Variant.h"
 
 namespace Engine::Renderer::Shader {
+    // Single pass preprocessor for #shader and #include over in-memory files. File contents are cached for all parsers
+    // and reread once their modification time changes.
     class Parser {
     public:
-        using ShaderStructsMap = std::unordered_map<std::string, std::vector<std::string> >;
         using ShaderDependencySet = std::unordered_set<std::string>;
 
         struct ParseCache {
@@ -25,7 +27,6 @@ namespace Engine::Renderer::Shader {
             ~ParseCache();
 
             ShaderDependencySet includedPaths;
-            ShaderStructsMap shaderStructs;
         };
 
         Parser() = delete;
@@ -38,15 +39,15 @@ namespace Engine::Renderer::Shader {
 
         Parser& operator=(Parser&&) = delete;
 
-        ~Parser();
+        ~Parser() = default;
 
-        explicit Parser(const std::string& filePath,
+        // Conditionals on the defines of the variant are resolved while parsing, see Variant.h
+        explicit Parser(const std::string& filePath, VariantMask variant = {},
                         const std::shared_ptr<ParseCache>& parseCache = std::make_shared<ParseCache>());
 
         void logParseFail(size_t lineNbr, std::string_view lineStr, const std::string& description) const;
 
-        [[nodiscard]] Source buildSource(uint32_t shaderType, const std::string& sourceString,
-                                         const std::vector<Uniform>& uniforms) const;
+        [[nodiscard]] Source buildSource(uint32_t shaderType, std::string sourceString) const;
 
         Source operator()();
 
@@ -55,8 +56,14 @@ namespace Engine::Renderer::Shader {
         }
 
     private:
+        // Appends the lines of an included file, nested includes are expanded in place
+        void appendInclude(std::string_view includeToken, std::string& output, size_t lineNbr) const;
+
         std::string m_filePath;
-        std::ifstream m_istream;
+        std::shared_ptr<const std::string> m_file;
+        size_t m_offset{};
+        size_t m_lineNbr{};
+        VariantMask m_variant{};
         uint32_t m_nextShaderType{Source::s_shaderHeader};
         std::shared_ptr<ParseCache> m_parseCache;
     };
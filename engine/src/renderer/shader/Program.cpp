@@ -1,14 +1,20 @@
 #include "Program.h"
 
+#include <algorithm>
 #include <array>
 #include <iostream>
+#include <string>
+#include <vector>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include "Parser.h"
+#include "ProgramCache.h"
+#include "renderer/GlState.h"
 #include "renderer/Renderer.h"
 #include "Source.h"
+#include "UniformBlock.h"
 
 void Engine::Renderer::Shader::Program::setUniform(const int32_t location, const int val) {
     RENDERER_API_CALL(glUniform1i(location, val));
@@ -18,6 +24,10 @@ void Engine::Renderer::Shader::Program::setUniform(const int32_t location, const
     RENDERER_API_CALL(glUniform1f(location, val));
 }
 
+void Engine::Renderer::Shader::Program::setUniform(const int32_t location, const glm::vec2& val) {
+    RENDERER_API_CALL(glUniform2fv(location, 1, glm::value_ptr(val)));
+}
+
 void Engine::Renderer::Shader::Program::setUniform(const int32_t location, const glm::vec3& val) {
     RENDERER_API_CALL(glUniform3fv(location, 1, glm::value_ptr(val)));
 }
@@ -30,16 +40,79 @@ void Engine::Renderer::Shader::Program::setUniform(const int32_t location, const
     RENDERER_API_CALL(glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(val)));
 }
 
-int32_t Engine::Renderer::Shader::Program::getUniformLocation(const std::string& name) const {
-    for (const auto& uniform: m_uniforms) {
-        if (uniform.m_name == name) {
-            return uniform.m_location;
+Engine::Renderer::Shader::Program::UniformSlot Engine::Renderer::Shader::Program::getUniformSlot(
+    const UniformHandle uniform) const {
+    if (const auto it = std::ranges::lower_bound(m_hashes, uniform.getHash());
+        it != m_hashes.end() && *it == uniform.getHash()) {
+        return UniformSlot{m_hashSlots[static_cast<size_t>(it - m_hashes.begin())]};
+    }
+
+    LOG_ERR("Uniform with name: " << uniform.getName() << " not found.\n");
+
+    return UniformSlot{};
+}
+
+int32_t Engine::Renderer::Shader::Program::getUniformLocation(const UniformHandle uniform) const {
+    const auto slot = getUniformSlot(uniform);
+    return slot.isValid() ? m_uniforms[slot.index].m_location : Uniform::noLocation;
+}
+
+namespace {
+    bool isSamplerType(const GLenum type) {
+        switch (type) {
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_2D_ARRAY:
+            case GL_SAMPLER_CUBE:
+            case GL_INT_SAMPLER_2D:
+            case GL_UNSIGNED_INT_SAMPLER_2D:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    [[maybe_unused]] bool acceptsValueType(const GLenum uniformType, const GLenum valueType) {
+        if (uniformType == valueType) {
+            return true;
         }
+
+        return valueType == GL_INT && (uniformType == GL_BOOL || isSamplerType(uniformType));
+    }
+}
+
+void Engine::Renderer::Shader::Program::stageUniform(const UniformSlot slot, const void* bytes, const size_t size,
+                                                     [[maybe_unused]] const uint32_t glType,
+                                                     const UploadFn upload) const {
+    if (!slot.isValid()) {
+        return;
+    }
+
+    ASSERT_MSG(acceptsValueType(m_uniforms[slot.index].m_type, glType),
+               "Value type does not match uniform: " << m_uniforms[slot.index].m_name << '\n');
+
+    auto& value = m_values[slot.index];
+    if (value.upload == upload && std::memcmp(value.bytes.data(), bytes, size) == 0) {
+        m_uniformStats.skipped++;
+        return;
     }
 
-    LOG_ERR("Uniform with name: " << name << " not found.\n");
+    std::memcpy(value.bytes.data(), bytes, size);
+    value.upload = upload;
+    if (!value.dirty) {
+        value.dirty = true;
+        m_dirty.push_back(slot.index);
+    }
+}
+
+void Engine::Renderer::Shader::Program::flushUniforms() const {
+    for (const uint32_t index: m_dirty) {
+        auto& value = m_values[index];
+        value.upload(m_uniforms[index].m_location, value.bytes.data());
+        value.dirty = false;
+        m_uniformStats.uploads++;
+    }
 
-    return Uniform::noLocation;
+    m_dirty.clear();
 }
 
 bool Engine::Renderer::Shader::Program::createProgram() {
@@ -51,9 +124,7 @@ bool Engine::Renderer::Shader::Program::createProgram() {
     return static_cast<bool>(m_id);
 }
 
-bool Engine::Renderer::Shader::Program::linkProgram() const {
-    RENDERER_API_CALL(glLinkProgram(m_id));
-
+bool Engine::Renderer::Shader::Program::checkLinked() const {
     int linkStatus = 0;
     RENDERER_API_CALL(glGetProgramiv(m_id, GL_LINK_STATUS, &linkStatus));
     if (linkStatus == 0) {
@@ -67,91 +138,236 @@ bool Engine::Renderer::Shader::Program::linkProgram() const {
 }
 
 void Engine::Renderer::Shader::Program::attachShader(const Source& source) {
-    auto appendUniforms = source.getUniforms();
-    m_uniforms.insert(m_uniforms.end(), appendUniforms.begin(), appendUniforms.end());
-
     RENDERER_API_CALL(glAttachShader(m_id, source.getId()));
 }
 
-bool Engine::Renderer::Shader::Program::locateUniforms() {
-    for (auto& uniform: m_uniforms) {
-        if (!uniform.locate(m_id)) {
-            return false;
+bool Engine::Renderer::Shader::Program::reflectUniforms() {
+    GLint count{};
+    GLint maxLength{};
+    RENDERER_API_CALL(glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &count));
+    RENDERER_API_CALL(glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+
+    m_uniforms.clear();
+    std::vector<std::pair<uint64_t, uint32_t>> names; // Hash and index into m_uniforms
+    const auto addName = [this, &names](const std::string_view uniformName) {
+        names.emplace_back(UniformHandle::fromName(uniformName).getHash(),
+                           static_cast<uint32_t>(m_uniforms.size() - 1));
+    };
+
+    std::string name(static_cast<size_t>(maxLength), '\0');
+    for (GLint i{}; i < count; i++) {
+        GLsizei length{};
+        GLint size{};
+        GLenum type{};
+        RENDERER_API_CALL(glGetActiveUniform(m_id, static_cast<GLuint>(i), maxLength, &length, &size, &type,
+            name.data()));
+
+        // Block members have no location, they are set through the block's buffer
+        const GLint location = RENDERER_API_CALL_RETURN(glGetUniformLocation(m_id, name.c_str()));
+        if (location == Uniform::noLocation) {
+            continue;
+        }
+
+        // Arrays are reported by their first element. The bare name is another name for it, so both share one
+        // entry and one shadowed value. The other elements get their own entry.
+        const std::string_view activeName{name.data(), static_cast<size_t>(length)};
+        if (!activeName.ends_with("[0]")) {
+            m_uniforms.push_back(Uniform{std::string{activeName}, location, type, size});
+            addName(activeName);
+            continue;
         }
+
+        const std::string arrayName{activeName.substr(0, activeName.size() - 3)};
+        m_uniforms.push_back(Uniform{arrayName + "[0]", location, type, size});
+        addName(arrayName);
+        addName(m_uniforms.back().m_name);
+        for (GLint element{1}; element < size; element++) {
+            auto elementName = arrayName + '[' + std::to_string(element) + ']';
+            const GLint elementLocation = RENDERER_API_CALL_RETURN(glGetUniformLocation(m_id, elementName.c_str()));
+            m_uniforms.push_back(Uniform{std::move(elementName), elementLocation, type, 1});
+            addName(m_uniforms.back().m_name);
+        }
+    }
+
+    std::ranges::sort(names);
+    m_hashes.clear();
+    m_hashSlots.clear();
+    for (const auto& [hash, index]: names) {
+        m_hashes.push_back(hash);
+        m_hashSlots.push_back(index);
     }
 
+#ifndef NDEBUG
+    // Two names on one hash would silently alias
+    const auto collision = std::ranges::adjacent_find(m_hashes);
+    ASSERT_MSG(collision == m_hashes.end(), "Uniform name hash collision in program " << m_id << ": "
+               << m_uniforms[m_hashSlots[static_cast<size_t>(collision - m_hashes.begin())]].m_name << '\n');
+#endif
+
+    m_values.assign(m_uniforms.size(), {});
+    m_dirty.clear();
     return true;
 }
 
-Engine::Renderer::Shader::Program::Program(Parser sourceParser) {
+void Engine::Renderer::Shader::Program::bindUniformBlocks() const {
+    GLint count{};
+    GLint maxLength{};
+    RENDERER_API_CALL(glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCKS, &count));
+    RENDERER_API_CALL(glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength));
+
+    std::string name(static_cast<size_t>(maxLength), '\0');
+    for (GLint i{}; i < count; i++) {
+        GLsizei length{};
+        RENDERER_API_CALL(glGetActiveUniformBlockName(m_id, static_cast<GLuint>(i), maxLength, &length,
+            name.data()));
+
+        const std::string_view block{name.data(), static_cast<size_t>(length)};
+        const auto binding = toBlockBinding(block);
+        if (!binding.has_value()) {
+            LOG_ERR("Uniform block: " << block << " has no binding point. Program id: " << m_id << '\n');
+            continue;
+        }
+
+        RENDERER_API_CALL(glUniformBlockBinding(m_id, static_cast<GLuint>(i), static_cast<GLuint>(*binding)));
+    }
+}
+
+bool Engine::Renderer::Shader::Program::build(const std::span<Source* const> sources) {
+    return finishBuild(sources, startBuild(sources));
+}
+
+Engine::Renderer::Shader::Program::PendingBuild Engine::Renderer::Shader::Program::startBuild(
+    const std::span<Source* const> sources) {
+    PendingBuild build{};
     if (!createProgram()) {
-        return;
+        return build;
     }
 
-    while (auto shader{sourceParser.next()}) {
-        shader.compile();
-        if (!shader.isCompiled()) {
-            LOG_ERR(&s_CreationFailStr << '\n');
-            return;
+    build.cached = ProgramCache::isSupported();
+    build.cacheKey = build.cached ? ProgramCache::key(sources) : 0;
+    build.loaded = build.cached && ProgramCache::load(m_id, build.cacheKey);
+    if (!build.loaded) {
+        for (auto* source: sources) {
+            source->startCompile();
+            if (source->getId() == 0) {
+                LOG_ERR(&s_CreationFailStr << '\n');
+                return build;
+            }
+
+            attachShader(*source);
         }
 
-        attachShader(shader);
+        if (build.cached) {
+            ProgramCache::markRetrievable(m_id);
+        }
+
+        RENDERER_API_CALL(glLinkProgram(m_id));
     }
 
-    if (!linkProgram()) {
-        return;
+    build.started = true;
+    return build;
+}
+
+bool Engine::Renderer::Shader::Program::isBuildDone() const {
+#ifdef GL_KHR_parallel_shader_compile
+    if (m_id != 0 && Renderer::getActiveRenderer()->getCapabilities().parallelShaderCompile) {
+        GLint done{};
+        RENDERER_API_CALL(glGetProgramiv(m_id, GL_COMPLETION_STATUS_KHR, &done));
+        return done != 0;
     }
+#endif
 
-    bind();
+    return true;
+}
 
-    if (!locateUniforms()) {
-        return;
+bool Engine::Renderer::Shader::Program::finishBuild(const std::span<Source* const> sources,
+                                                    const PendingBuild& build) {
+    if (!build.started) {
+        return false;
+    }
+
+    if (!build.loaded) {
+        // Every stage is checked so all compile errors get logged, not just the first
+        bool compiled{true};
+        for (auto* source: sources) {
+            compiled = source->checkCompiled() && compiled;
+        }
+
+        if (!compiled) {
+            LOG_ERR(&s_CreationFailStr << '\n');
+            return false;
+        }
+
+        if (!checkLinked()) {
+            return false;
+        }
+
+        if (build.cached) {
+            ProgramCache::store(m_id, build.cacheKey);
+        }
     }
+
+    bindUniformBlocks();
+    bind();
+
+    return reflectUniforms();
 }
 
-Engine::Renderer::Shader::Program::Program(const std::initializer_list<std::string> paths) {
-    if (!createProgram()) {
-        return;
+std::vector<Engine::Renderer::Shader::Source> Engine::Renderer::Shader::Program::parseSources(Parser& parser) {
+    std::vector<Source> sources;
+    while (auto shader{parser.next()}) {
+        sources.push_back(std::move(shader));
     }
 
+    return sources;
+}
+
+std::vector<Engine::Renderer::Shader::Source> Engine::Renderer::Shader::Program::parseSources(
+    const std::initializer_list<std::string> paths) {
+    std::vector<Source> sources;
     for (const auto& path: paths) {
         Parser parser{path};
 
         while (auto shader{parser.next()}) {
-            shader.compile();
-            if (!shader.isCompiled()) {
-                LOG_ERR(&s_CreationFailStr << '\n');
-                return;
-            }
-
-            attachShader(shader);
+            sources.push_back(std::move(shader));
         }
     }
 
-    if (!linkProgram()) {
-        return;
+    return sources;
+}
+
+std::vector<Engine::Renderer::Shader::Source*> Engine::Renderer::Shader::Program::pointersTo(
+    std::vector<Source>& sources) {
+    std::vector<Source*> pointers;
+    pointers.reserve(sources.size());
+    for (auto& source: sources) {
+        pointers.push_back(&source);
     }
 
-    bind();
+    return pointers;
+}
 
-    if (!locateUniforms()) {
-        return;
-    }
+Engine::Renderer::Shader::Program::Program(Parser sourceParser) {
+    auto sources = parseSources(sourceParser);
+    build(pointersTo(sources));
 }
 
-void Engine::Renderer::Shader::Program::bind() const {
-    static Id s_bound{};
+Engine::Renderer::Shader::Program::Program(const std::initializer_list<std::string> paths) {
+    auto sources = parseSources(paths);
+    build(pointersTo(sources));
+}
 
-    if (m_id == s_bound) {
-        return;
-    }
+Engine::Renderer::Shader::Program::Program(std::vector<Source> sources) {
+    build(pointersTo(sources));
+}
 
-    RENDERER_API_CALL(glUseProgram(m_id));
-    s_bound = m_id;
+void Engine::Renderer::Shader::Program::bind() const {
+    GlState::current().useProgram(m_id);
+    flushUniforms();
 }
 
 void Engine::Renderer::Shader::Program::unbind() {
-    RENDERER_API_CALL(glUseProgram(0));
+    GlState::current().useProgram(0);
 }
 
 void Engine::Renderer::Shader::Program::destroy() const {
@@ -161,6 +377,7 @@ void Engine::Renderer::Shader::Program::destroy() const {
 
     unbind();
     RENDERER_API_CALL(glDeleteProgram(m_id));
+    GlState::current().onProgramDeleted(m_id);
 }
 
 Engine::Renderer::Shader::Program::~Program() {
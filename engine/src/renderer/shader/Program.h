@@ -1,11 +1,17 @@
 #pragma once
 
+#include <array>
+#include <cstring>
 #include <iostream>
+#include <span>
+#include <type_traits>
 #include <vector>
+#include <glad/glad.h>
 #include <glm/fwd.hpp>
 #include <glm/vec4.hpp>
 
 #include "Uniform.h"
+#include "UniformHandle.h"
 #include "core/Typedef.h"
 #include "core/Log.h"
 
@@ -19,6 +25,23 @@ namespace Engine::Renderer::Shader {
 
     class Program {
     public:
+        // Of setUniform calls through handles, counted since the last reset
+        struct UniformStats {
+            uint32_t uploads{};
+            uint32_t skipped{}; // Value equal to the last one set
+        };
+
+        // Index into the uniform table, resolved once and then set without any lookup
+        struct UniformSlot {
+            static constexpr uint32_t s_none{~uint32_t{}};
+
+            uint32_t index{s_none};
+
+            [[nodiscard]] bool isValid() const {
+                return index != s_none;
+            }
+        };
+
         template<typename... Args>
         explicit Program(Args&... shaders);
 
@@ -26,11 +49,18 @@ namespace Engine::Renderer::Shader {
 
         explicit Program(std::initializer_list<std::string> paths);
 
+        // Already preprocessed stages, see ProgramVariants
+        explicit Program(std::vector<Source> sources);
+
         Program(const Program&) = delete;
 
         Program& operator=(const Program&) = delete;
 
-        Program(Program&& other) noexcept : m_uniforms{std::move(other.m_uniforms)}, m_id{other.m_id} {
+        Program(Program&& other) noexcept : m_uniforms{std::move(other.m_uniforms)},
+                                            m_hashes{std::move(other.m_hashes)},
+                                            m_hashSlots{std::move(other.m_hashSlots)},
+                                            m_values{std::move(other.m_values)}, m_dirty{std::move(other.m_dirty)},
+                                            m_uniformStats{other.m_uniformStats}, m_id{other.m_id} {
             other.m_id = {};
         }
 
@@ -40,6 +70,11 @@ namespace Engine::Renderer::Shader {
             }
 
             m_uniforms = std::move(other.m_uniforms);
+            m_hashes = std::move(other.m_hashes);
+            m_hashSlots = std::move(other.m_hashSlots);
+            m_values = std::move(other.m_values);
+            m_dirty = std::move(other.m_dirty);
+            m_uniformStats = other.m_uniformStats;
             m_id = other.m_id;
             other.m_id = {};
             return *this;
@@ -52,6 +87,7 @@ namespace Engine::Renderer::Shader {
 
         ~Program();
 
+        // Also uploads the uniform values changed since the last bind
         void bind() const;
 
         static void unbind();
@@ -64,59 +100,146 @@ namespace Engine::Renderer::Shader {
             return m_id;
         }
 
-        [[nodiscard]] int32_t getUniformLocation(const std::string& name) const;
+        [[nodiscard]] int32_t getUniformLocation(UniformHandle uniform) const;
+
+        [[nodiscard]] UniformSlot getUniformSlot(UniformHandle uniform) const;
+
+        // Active uniforms found by reflection after linking, array elements get an entry each
+        [[nodiscard]] std::span<const Uniform> getUniforms() const {
+            return m_uniforms;
+        }
 
         static void setUniform(int32_t location, int val);
 
         static void setUniform(int32_t location, float val);
 
+        static void setUniform(int32_t location, const glm::vec2& val);
+
         static void setUniform(int32_t location, const glm::vec3& val);
 
         static void setUniform(int32_t location, const glm::vec4& val);
 
         static void setUniform(int32_t location, const glm::mat4& val);
 
-        template<typename... T>
-        void setUniform(const std::string& name, T... val) const {
-            Program::setUniform(getUniformLocation(name), val...);
+        // Shadowed per location, values equal to the last one set are dropped. The rest is uploaded on the next bind,
+        // so the program does not need to be bound. The location overloads above bypass the shadow.
+        // Debug builds check the value type against the type the driver reports.
+        template<typename T>
+        void setUniform(const UniformSlot slot, const T& val) const {
+            static_assert(sizeof(T) <= sizeof(UniformValue::bytes));
+            stageUniform(slot, &val, sizeof(T), toGlUniformType<T>(), uploadUniform<T>);
+        }
+
+        template<typename T>
+        void setUniform(const UniformHandle uniform, const T& val) const {
+            setUniform(getUniformSlot(uniform), val);
+        }
+
+        [[nodiscard]] const UniformStats& getUniformStats() const {
+            return m_uniformStats;
+        }
+
+        void resetUniformStats() const {
+            m_uniformStats = {};
         }
 
     private:
+        friend class ProgramFuture;
+        friend class ProgramVariants;
+
         static constexpr char s_CreationFailStr[] = "Failed to create shader program.";
 
+        // Carried from startBuild to finishBuild
+        struct PendingBuild {
+            uint64_t cacheKey{};
+            bool started{};
+            bool cached{}; // Goes into ProgramCache once linked
+            bool loaded{}; // Came out of ProgramCache, nothing was compiled
+        };
+
+        Program() = default;
+
+        using UploadFn = void (*)(int32_t location, const void* bytes);
+
+        struct UniformValue {
+            std::array<std::byte, sizeof(float) * 16> bytes{};
+            UploadFn upload{}; // Also tells the type, none until the first set
+            bool dirty{};
+        };
+
+        template<typename T>
+        static constexpr uint32_t toGlUniformType() {
+            if constexpr (std::is_same_v<T, int>) {
+                return GL_INT; // Also fits bools and samplers
+            } else if constexpr (std::is_same_v<T, float>) {
+                return GL_FLOAT;
+            } else if constexpr (std::is_same_v<T, glm::vec2>) {
+                return GL_FLOAT_VEC2;
+            } else if constexpr (std::is_same_v<T, glm::vec3>) {
+                return GL_FLOAT_VEC3;
+            } else if constexpr (std::is_same_v<T, glm::vec4>) {
+                return GL_FLOAT_VEC4;
+            } else {
+                static_assert(std::is_same_v<T, glm::mat4>, "No setUniform overload for this type");
+                return GL_FLOAT_MAT4;
+            }
+        }
+
+        template<typename T>
+        static void uploadUniform(const int32_t location, const void* bytes) {
+            T val;
+            std::memcpy(&val, bytes, sizeof(T));
+            Program::setUniform(location, val);
+        }
+
+        void stageUniform(UniformSlot slot, const void* bytes, size_t size, uint32_t glType, UploadFn upload) const;
+
+        void flushUniforms() const;
+
+        // Loads the linked program from ProgramCache, or compiles and links the sources and stores the result
+        bool build(std::span<Source* const> sources);
+
+        // Issues compile and link without asking for their status, so the driver may work on them in the background
+        PendingBuild startBuild(std::span<Source* const> sources);
+
+        // Whether finishBuild would not block, always true without KHR_parallel_shader_compile
+        [[nodiscard]] bool isBuildDone() const;
+
+        bool finishBuild(std::span<Source* const> sources, const PendingBuild& build);
+
+        // Every stage of the files, preprocessed up front so the cache key covers all of them
+        static std::vector<Source> parseSources(Parser& parser);
+
+        static std::vector<Source> parseSources(std::initializer_list<std::string> paths);
+
+        static std::vector<Source*> pointersTo(std::vector<Source>& sources);
+
         [[nodiscard]] bool createProgram();
 
-        [[nodiscard]] bool linkProgram() const;
+        [[nodiscard]] bool checkLinked() const;
 
         void attachShader(const Source& source);
 
-        bool locateUniforms();
+        // Builds the uniform table from the active uniforms of the linked program
+        bool reflectUniforms();
+
+        // Points every active block at its fixed binding, see UniformBlock.h
+        void bindUniformBlocks() const;
 
         std::vector<Uniform> m_uniforms;
+        // Sorted name hashes and the m_uniforms index each one names. An array's bare name and its [0] share an index.
+        std::vector<uint64_t> m_hashes;
+        std::vector<uint32_t> m_hashSlots;
+        // Last values set, parallel to m_uniforms
+        mutable std::vector<UniformValue> m_values;
+        mutable std::vector<uint32_t> m_dirty;
+        mutable UniformStats m_uniformStats;
         Id m_id{};
     };
 
     template<typename... Args>
     Program::Program(Args&... shaders) {
-        if (!createProgram()) {
-            return;
-        }
-
-        if (const bool success = ((shaders.compile(), shaders.isCompiled()) && ...); !success) {
-            LOG_ERR(&s_CreationFailStr << '\n');
-            return;
-        }
-
-        (attachShader(shaders), ...);
-
-        if (!linkProgram()) {
-            return;
-        }
-
-        bind();
-
-        if (!locateUniforms()) {
-            return;
-        }
+        const std::array<Source*, sizeof...(Args)> sources{&shaders...};
+        build(sources);
     }
 }
@@ -0,0 +1,177 @@
+#include "ProgramCache.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+#include <glad/glad.h>
+
+#include "Source.h"
+#include "core/Hash.h"
+#include "core/Log.h"
+#include "core/MappedFile.h"
+#include "renderer/Renderer.h"
+
+namespace {
+    constexpr std::array<char, 4> s_magic{'F', 'P', 'S', 'P'};
+
+    struct Header {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t binaryFormat;
+        uint32_t binarySize;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header>);
+}
+
+Engine::Renderer::Shader::ProgramCache::Stats Engine::Renderer::Shader::ProgramCache::s_stats{};
+
+bool Engine::Renderer::Shader::ProgramCache::isSupported() {
+    return Renderer::getActiveRenderer()->getCapabilities().programBinary;
+}
+
+uint64_t Engine::Renderer::Shader::ProgramCache::key(const std::span<Source* const> sources) {
+    uint64_t hash = Hash::mix64(driverHash() ^ s_version);
+    for (const auto* source: sources) {
+        const auto type = source->getType();
+        hash = Hash::bytes(&type, sizeof(type), hash);
+        hash = Hash::fnv1a64(source->getSource(), hash);
+    }
+
+    return hash;
+}
+
+uint64_t Engine::Renderer::Shader::ProgramCache::driverHash() {
+    // The driver can not change while the process runs
+    static const uint64_t hash = [] {
+        uint64_t result{Hash::s_fnvOffset64};
+        for (const GLenum name: std::array<GLenum, 3>{GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+            const auto* string = reinterpret_cast<const char*>(RENDERER_API_CALL_RETURN(glGetString(name)));
+            result = Hash::fnv1a64(string != nullptr ? string : "", result);
+        }
+
+        return result;
+    }();
+
+    return hash;
+}
+
+bool Engine::Renderer::Shader::ProgramCache::isKnownFormat([[maybe_unused]] const uint32_t format) {
+#ifdef GL_ARB_get_program_binary
+    GLint count{};
+    RENDERER_API_CALL(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count));
+    std::vector<GLint> formats(static_cast<size_t>(count));
+    RENDERER_API_CALL(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data()));
+    return std::ranges::find(formats, static_cast<GLint>(format)) != formats.end();
+#else
+    return false;
+#endif
+}
+
+std::string Engine::Renderer::Shader::ProgramCache::cachedPath(const uint64_t key) {
+    std::array<char, 17> keyString{};
+    std::to_chars(keyString.data(), keyString.data() + keyString.size() - 1, key, 16);
+    return std::string{ENGINE_CACHE_PATH"/program-"} + keyString.data() + ".fpsp";
+}
+
+void Engine::Renderer::Shader::ProgramCache::markRetrievable([[maybe_unused]] const Id program) {
+#ifdef GL_ARB_get_program_binary
+    RENDERER_API_CALL(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+#endif
+}
+
+bool Engine::Renderer::Shader::ProgramCache::load([[maybe_unused]] const Id program,
+                                                  [[maybe_unused]] const uint64_t key) {
+#ifdef GL_ARB_get_program_binary
+    const auto path = cachedPath(key);
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) {
+        s_stats.misses++;
+        return false;
+    }
+
+    const MappedFile file{path};
+    Header header{};
+    if (file.isOpen() && file.size() >= sizeof(Header)) {
+        std::memcpy(&header, file.data(), sizeof(Header));
+    }
+
+    if (header.magic != s_magic || header.version != s_version || header.key != key ||
+        sizeof(Header) + header.binarySize > file.size() || !isKnownFormat(header.binaryFormat)) {
+        s_stats.misses++;
+        return false;
+    }
+
+    RENDERER_API_CALL(glProgramBinary(program, header.binaryFormat, file.data() + sizeof(Header),
+        static_cast<GLsizei>(header.binarySize)));
+
+    GLint linkStatus{};
+    RENDERER_API_CALL(glGetProgramiv(program, GL_LINK_STATUS, &linkStatus));
+    if (linkStatus == 0) {
+        LOG("Driver rejected cached program, building it from source: " << path << '\n');
+        s_stats.rejected++;
+        s_stats.misses++;
+        return false;
+    }
+
+    s_stats.hits++;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Engine::Renderer::Shader::ProgramCache::store([[maybe_unused]] const Id program,
+                                                   [[maybe_unused]] const uint64_t key) {
+#ifdef GL_ARB_get_program_binary
+    GLint length{};
+    RENDERER_API_CALL(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> bytes(sizeof(Header) + static_cast<size_t>(length));
+    GLsizei written{};
+    GLenum format{};
+    RENDERER_API_CALL(glGetProgramBinary(program, length, &written, &format, bytes.data() + sizeof(Header)));
+    if (written <= 0) {
+        return false;
+    }
+
+    const Header header{s_magic, s_version, key, format, static_cast<uint32_t>(written)};
+    std::memcpy(bytes.data(), &header, sizeof(Header));
+    bytes.resize(sizeof(Header) + static_cast<size_t>(written));
+
+    const std::filesystem::path path{cachedPath(key)};
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    // Written next to the target and renamed, so a crash never leaves a half written file behind
+    const auto tempPath = std::filesystem::path{path}.concat(".tmp");
+    {
+        std::ofstream file{tempPath, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            LOG_ERR("Could not write program binary: " << tempPath.string() << '\n');
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_ERR("Could not move program binary into place: " << path.string() << '\n');
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "core/Typedef.h"
+
+namespace Engine::Renderer::Shader {
+    class Source;
+
+    // Linked program binaries on disk, keyed on the preprocessed sources and the driver that built them. Skips
+    // compiling and linking on later runs, which matters most on software drivers.
+    class ProgramCache {
+    public:
+        static constexpr uint32_t s_version{1};
+
+        struct Stats {
+            uint32_t hits{};
+            uint32_t misses{};
+            uint32_t rejected{}; // Found, but the driver did not take the binary. Also counted as a miss.
+        };
+
+        [[nodiscard]] static bool isSupported();
+
+        [[nodiscard]] static uint64_t key(std::span<Source* const> sources);
+
+        static std::string cachedPath(uint64_t key);
+
+        // Must be set before linking, or the driver may not keep the binary around
+        static void markRetrievable(Id program);
+
+        // Loads the cached binary into the program, false if there is none or the driver rejected it
+        static bool load(Id program, uint64_t key);
+
+        static bool store(Id program, uint64_t key);
+
+        [[nodiscard]] static const Stats& getStats() {
+            return s_stats;
+        }
+
+    private:
+        // Vendor, renderer and version strings, a binary is only valid for the exact driver that made it
+        static uint64_t driverHash();
+
+        // A format the driver does not list fails with GL_INVALID_ENUM instead of a failed link
+        static bool isKnownFormat(uint32_t format);
+
+        static Stats s_stats;
+    };
+}
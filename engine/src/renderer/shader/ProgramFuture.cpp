@@ -0,0 +1,43 @@
+#include "ProgramFuture.h"
+
+#include "Parser.h"
+
+Engine::Renderer::Shader::ProgramFuture::ProgramFuture(Parser sourceParser) : m_sources{
+    Program::parseSources(sourceParser)
+} {
+    start();
+}
+
+Engine::Renderer::Shader::ProgramFuture::ProgramFuture(const std::initializer_list<std::string> paths) : m_sources{
+    Program::parseSources(paths)
+} {
+    start();
+}
+
+void Engine::Renderer::Shader::ProgramFuture::start() {
+    m_build = m_program.startBuild(Program::pointersTo(m_sources));
+}
+
+bool Engine::Renderer::Shader::ProgramFuture::isReady() const {
+    return m_finished || m_program.isBuildDone();
+}
+
+Engine::Renderer::Shader::Program& Engine::Renderer::Shader::ProgramFuture::get() {
+    if (!m_finished) {
+        m_valid = m_program.finishBuild(Program::pointersTo(m_sources), m_build);
+        m_finished = true;
+        // Linked programs keep working without their shader objects
+        m_sources.clear();
+    }
+
+    return m_program;
+}
+
+const Engine::Renderer::Shader::Program& Engine::Renderer::Shader::ProgramFuture::getOr(const Program& fallback) {
+    if (!isReady()) {
+        return fallback;
+    }
+
+    get();
+    return m_valid ? m_program : fallback;
+}
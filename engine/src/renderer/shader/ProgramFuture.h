@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Program.h"
+#include "Source.h"
+
+namespace Engine::Renderer::Shader {
+    class Parser;
+
+    // Program the driver compiles and links in the background, the way std::future hands out a result. Start them
+    // all at scene load and draw something else until they are ready.
+    class ProgramFuture {
+    public:
+        explicit ProgramFuture(Parser sourceParser);
+
+        explicit ProgramFuture(std::initializer_list<std::string> paths);
+
+        ProgramFuture(const ProgramFuture&) = delete;
+
+        ProgramFuture& operator=(const ProgramFuture&) = delete;
+
+        // Moving is fine, the sources live on the heap and the program only keeps its id
+        ProgramFuture(ProgramFuture&&) noexcept = default;
+
+        ProgramFuture& operator=(ProgramFuture&&) noexcept = default;
+
+        ~ProgramFuture() = default;
+
+        // Never blocks. Without KHR_parallel_shader_compile there is nothing to poll, so it is ready at once and
+        // get does the waiting.
+        [[nodiscard]] bool isReady() const;
+
+        // Finishes the build on the first call, waiting for the driver if it is not ready yet
+        Program& get();
+
+        // The program once ready, the fallback until then and for good if the build failed
+        const Program& getOr(const Program& fallback);
+
+        // Only meaningful after get, a failed build leaves an unusable program behind
+        [[nodiscard]] bool isValid() const {
+            return m_finished && m_valid;
+        }
+
+    private:
+        void start();
+
+        std::vector<Source> m_sources;
+        Program m_program;
+        Program::PendingBuild m_build;
+        bool m_finished{};
+        bool m_valid{};
+    };
+}
@@ -0,0 +1,26 @@
+#include "ProgramVariants.h"
+
+#include "Parser.h"
+#include "ProgramCache.h"
+#include "Source.h"
+
+const Engine::Renderer::Shader::Program& Engine::Renderer::Shader::ProgramVariants::get(const VariantMask variant) {
+    if (const auto it = m_byMask.find(variant); it != m_byMask.end()) {
+        return *it->second;
+    }
+
+    Parser parser{m_filePath, variant};
+    auto sources = Program::parseSources(parser);
+    const uint64_t sourceHash = ProgramCache::key(Program::pointersTo(sources));
+
+    const Program* program{};
+    if (const auto it = m_bySource.find(sourceHash); it != m_bySource.end()) {
+        program = it->second;
+    } else {
+        program = &m_programs.emplace_back(std::move(sources));
+        m_bySource.emplace(sourceHash, program);
+    }
+
+    m_byMask.emplace(variant, program);
+    return *program;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#include "Program.h"
+#include "Variant.h"
+
+namespace Engine::Renderer::Shader {
+    // Permutations of one shader file. A program is built the first time its mask is asked for, masks whose sources
+    // come out the same after preprocessing share one program.
+    class ProgramVariants {
+    public:
+        explicit ProgramVariants(std::string filePath) : m_filePath{std::move(filePath)} {
+        }
+
+        const Program& get(VariantMask variant);
+
+        // Distinct programs built so far, at most one per mask asked for
+        [[nodiscard]] size_t getProgramCount() const {
+            return m_programs.size();
+        }
+
+    private:
+        std::string m_filePath;
+        std::deque<Program> m_programs; // Never moves its elements, the maps point into it
+        std::unordered_map<VariantMask, const Program*> m_byMask;
+        std::unordered_map<uint64_t, const Program*> m_bySource;
+    };
+}
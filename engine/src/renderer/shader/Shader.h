@@ -15,9 +15,28 @@ namespace Engine::Renderer::Shader {
             std::is_same_v<T, float> || std::is_same_v<T, int>;
 
     enum class DataType : uint8_t {
-        None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool
+        None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool,
+        // Compact vertex attribute types. Read as floats in the shader, shorts usually normalized
+        Short2, Short4, UShort2, UShort3, UShort4
     };
 
+    // Integer types that reach the shader as integers, unless the attribute is normalized
+    inline bool isIntegerDataType(const DataType type) {
+        switch (type) {
+            case DataType::Int:
+            case DataType::Int2:
+            case DataType::Int3:
+            case DataType::Int4:
+            case DataType::Bool:
+            case DataType::Short2:
+            case DataType::Short4:
+            case DataType::UShort2:
+            case DataType::UShort3:
+            case DataType::UShort4: return true;
+            default: return false;
+        }
+    }
+
     using DataTypeComponentCount = uint8_t;
 
     inline uint32_t dataTypeSize(const DataType type) {
@@ -33,6 +52,11 @@ namespace Engine::Renderer::Shader {
             case DataType::Int3: return 4 * 3;
             case DataType::Int4: return 4 * 4;
             case DataType::Bool: return 1;
+            case DataType::Short2: return 2 * 2;
+            case DataType::Short4: return 2 * 4;
+            case DataType::UShort2: return 2 * 2;
+            case DataType::UShort3: return 2 * 3;
+            case DataType::UShort4: return 2 * 4;
             default: break;
         }
 
@@ -53,6 +77,11 @@ namespace Engine::Renderer::Shader {
             case DataType::Int3: return 3;
             case DataType::Int4: return 4;
             case DataType::Bool: return 1;
+            case DataType::Short2: return 2;
+            case DataType::Short4: return 4;
+            case DataType::UShort2: return 2;
+            case DataType::UShort3: return 3;
+            case DataType::UShort4: return 4;
             default: break;
         }
 
@@ -60,6 +89,15 @@ namespace Engine::Renderer::Shader {
         return 0;
     }
 
+    // Attribute locations a type takes up. A location holds at most 4 components, so matrices take one per column.
+    inline uint32_t slotCount(const DataType type) {
+        switch (type) {
+            case DataType::Mat3: return 3;
+            case DataType::Mat4: return 4;
+            default: return 1;
+        }
+    }
+
 
     template<typename T>
     consteval DataType toShaderDataType() {
@@ -122,6 +160,31 @@ namespace Engine::Renderer::Shader {
         return DataType::Bool;
     }
 
+    template<>
+    consteval DataType toShaderDataType<glm::i16vec2>() {
+        return DataType::Short2;
+    }
+
+    template<>
+    consteval DataType toShaderDataType<glm::i16vec4>() {
+        return DataType::Short4;
+    }
+
+    template<>
+    consteval DataType toShaderDataType<glm::u16vec2>() {
+        return DataType::UShort2;
+    }
+
+    template<>
+    consteval DataType toShaderDataType<glm::u16vec3>() {
+        return DataType::UShort3;
+    }
+
+    template<>
+    consteval DataType toShaderDataType<glm::u16vec4>() {
+        return DataType::UShort4;
+    }
+
     inline GLenum toGlDataType(const DataType type) {
         switch (type) {
             case DataType::None: break;
@@ -136,6 +199,11 @@ namespace Engine::Renderer::Shader {
             case DataType::Int3: return GL_INT;
             case DataType::Int4: return GL_INT;
             case DataType::Bool: return GL_BOOL;
+            case DataType::Short2: return GL_SHORT;
+            case DataType::Short4: return GL_SHORT;
+            case DataType::UShort2: return GL_UNSIGNED_SHORT;
+            case DataType::UShort3: return GL_UNSIGNED_SHORT;
+            case DataType::UShort4: return GL_UNSIGNED_SHORT;
             default: break;
         }
 
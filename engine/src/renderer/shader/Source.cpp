@@ -15,29 +15,38 @@ void Engine::Renderer::Shader::Source::destroy() {
 }
 
 void Engine::Renderer::Shader::Source::compile() {
+    startCompile();
+    checkCompiled();
+}
+
+void Engine::Renderer::Shader::Source::startCompile() {
     if (m_type == s_shaderHeader) {
         LOG_ERR("Shader compilation failed: " << "Shaders of type 0 (shader header) cannot be compiled.\n");
         return;
     }
 
-    const auto shaderId = RENDERER_API_CALL_RETURN(glCreateShader(m_type));
+    destroy();
+    m_id = RENDERER_API_CALL_RETURN(glCreateShader(m_type));
     const auto* const src = m_source.c_str();
-    RENDERER_API_CALL(glShaderSource(shaderId, 1, &src, nullptr));
-    RENDERER_API_CALL(glCompileShader(shaderId));
+    RENDERER_API_CALL(glShaderSource(m_id, 1, &src, nullptr));
+    RENDERER_API_CALL(glCompileShader(m_id));
+}
+
+bool Engine::Renderer::Shader::Source::checkCompiled() {
+    if (m_id == 0) {
+        return false;
+    }
 
     int success{};
-    RENDERER_API_CALL(glGetShaderiv(shaderId, GL_COMPILE_STATUS, &success));
+    RENDERER_API_CALL(glGetShaderiv(m_id, GL_COMPILE_STATUS, &success));
     if (success == 0) {
         std::array<char, 512> infoLog{};
         RENDERER_API_CALL(
-            glGetShaderInfoLog(shaderId, infoLog.size(), nullptr, infoLog.data()));
+            glGetShaderInfoLog(m_id, infoLog.size(), nullptr, infoLog.data()));
         LOG_ERR("Shader compilation failed:\n" << infoLog.data() << "\n");
-        return;
+        destroy();
+        return false;
     }
 
-    m_id = shaderId;
-}
-
-const std::vector<Engine::Renderer::Shader::Uniform>& Engine::Renderer::Shader::Source::getUniforms() const {
-    return m_uniforms;
+    return true;
 }
@@ -1,9 +1,7 @@
 #pragma once
 
 #include <string>
-#include <vector>
 
-#include "Uniform.h"
 #include "core/Typedef.h"
 
 namespace Engine::Renderer {
@@ -19,10 +17,8 @@ namespace Engine::Renderer::Shader {
 
         Source() = default;
 
-        Source(const Type type, std::string source, std::vector<Uniform> uniforms = {}) : m_source{
+        Source(const Type type, std::string source) : m_source{
                 std::move(source)
-            }, m_uniforms{
-                std::move(uniforms)
             }, m_type{type} {
         }
 
@@ -30,8 +26,7 @@ namespace Engine::Renderer::Shader {
 
         Source& operator=(const Source&) = delete;
 
-        Source(Source&& other) noexcept : m_source{std::move(other.m_source)}, m_uniforms{std::move(other.m_uniforms)},
-                                          m_id{other.m_id},
+        Source(Source&& other) noexcept : m_source{std::move(other.m_source)}, m_id{other.m_id},
                                           m_type{other.m_type} {
             other.m_id = {};
         }
@@ -42,7 +37,6 @@ namespace Engine::Renderer::Shader {
             }
 
             m_source = std::move(other.m_source);
-            m_uniforms = std::move(other.m_uniforms);
             m_type = other.m_type;
             m_id = other.m_id;
             other.m_id = {};
@@ -62,6 +56,11 @@ namespace Engine::Renderer::Shader {
 
         void compile();
 
+        // Hands the source to the driver without waiting for the result, checkCompiled collects it
+        void startCompile();
+
+        bool checkCompiled();
+
         [[nodiscard]] auto getId() const {
             return m_id;
         }
@@ -70,7 +69,7 @@ namespace Engine::Renderer::Shader {
             return m_type;
         }
 
-        [[nodiscard]] auto getSource() const {
+        [[nodiscard]] const std::string& getSource() const {
             return m_source;
         }
 
@@ -78,11 +77,8 @@ namespace Engine::Renderer::Shader {
             return !m_source.empty();
         }
 
-        [[nodiscard]] const std::vector<Uniform>& getUniforms() const;
-
     private:
         std::string m_source;
-        std::vector<Uniform> m_uniforms;
         Id m_id{};
         Type m_type{s_shaderHeader};
     };
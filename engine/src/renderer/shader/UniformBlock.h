@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+namespace Engine::Renderer::Shader {
+    // Binding points of the uniform blocks declared in res/shader/include. Programs bind their blocks by name after
+    // linking, the renderer keeps one uniform buffer bound to each point.
+    enum class BlockBinding : uint8_t {
+        CAMERA = 0, // Camera.glsl
+        LIGHTS = 1, // Light.glsl
+        COUNT
+    };
+
+    inline std::optional<BlockBinding> toBlockBinding(const std::string_view blockName) {
+        if (blockName == "Camera") {
+            return BlockBinding::CAMERA;
+        }
+
+        if (blockName == "Lights") {
+            return BlockBinding::LIGHTS;
+        }
+
+        return std::nullopt;
+    }
+
+    // std140 mirrors of the blocks. vec3s start at 16 byte boundaries, a float may fill the rest of one.
+    struct CameraBlock {
+        glm::mat4 view{1.f};
+        glm::mat4 projection{1.f};
+        alignas(16) glm::vec3 viewPos{};
+    };
+
+    struct DirectionalLight {
+        alignas(16) glm::vec3 direction{};
+        alignas(16) glm::vec3 ambient{};
+        alignas(16) glm::vec3 diffuse{};
+        alignas(16) glm::vec3 specular{};
+    };
+
+    struct PointLight {
+        alignas(16) glm::vec3 position{};
+        alignas(16) glm::vec3 ambient{};
+        alignas(16) glm::vec3 diffuse{};
+        alignas(16) glm::vec3 specular{};
+        float constant{1.f};
+        float linear{};
+        float quadratic{};
+    };
+
+    struct LightBlock {
+        DirectionalLight directional;
+        PointLight point;
+    };
+
+    static_assert(offsetof(CameraBlock, viewPos) == 128);
+    static_assert(sizeof(DirectionalLight) == 64);
+    static_assert(offsetof(PointLight, constant) == 60 && sizeof(PointLight) == 80);
+    static_assert(offsetof(LightBlock, point) == 64);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "core/Hash.h"
+
+namespace Engine::Renderer::Shader {
+    // Uniform name hashed at compile time, so setUniform("u_model", ...) neither allocates nor compares strings.
+    // Names only known at runtime go through fromName.
+    class UniformHandle {
+    public:
+        consteval UniformHandle(const char* name) : UniformHandle{std::string_view{name}, 0} {
+        }
+
+        static constexpr UniformHandle fromName(const std::string_view name) {
+            return UniformHandle{name, 0};
+        }
+
+        [[nodiscard]] constexpr uint64_t getHash() const {
+            return m_hash;
+        }
+
+        // Has to outlive the handle, literals always do
+        [[nodiscard]] constexpr std::string_view getName() const {
+            return m_name;
+        }
+
+    private:
+        constexpr UniformHandle(const std::string_view name, int) : m_name{name}, m_hash{Hash::fnv1a64(name)} {
+        }
+
+        std::string_view m_name;
+        uint64_t m_hash{};
+    };
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace Engine::Renderer::Shader {
+    // Optional features of a shader. Each is a define the sources test with #ifdef and #ifndef, the parser resolves
+    // those so the branches a variant does not use never reach the compiler.
+    enum class Variant : uint8_t {
+        MATERIAL_MAP = 0, // Material sampled from diffuse, specular and emission maps
+        POINT_LIGHT = 1, // Lit by the point light instead of the directional one
+        VERTEX_COLOR = 2, // Per vertex tint at attribute location 3
+        INSTANCED = 3, // Per instance model matrix at attribute locations 4 to 7
+        // Color and material maps from layers of one TextureArray, per instance region at attribute locations 8 and 9.
+        // Needs INSTANCED.
+        TEXTURE_ARRAY = 4,
+        COUNT
+    };
+
+    // Bit per Variant, 0 is the plain shader
+    using VariantMask = uint32_t;
+
+    inline constexpr std::array<std::string_view, static_cast<size_t>(Variant::COUNT)> s_variantDefines{
+        "MATERIAL_MAP", "POINT_LIGHT", "VERTEX_COLOR", "INSTANCED", "TEXTURE_ARRAY"
+    };
+
+    constexpr VariantMask toMask(const Variant variant) {
+        return VariantMask{1} << static_cast<uint8_t>(variant);
+    }
+
+    template<typename... Args>
+    constexpr VariantMask toMask(const Variant variant, const Args... variants) {
+        return (toMask(variant) | ... | toMask(variants));
+    }
+
+    inline std::optional<Variant> toVariant(const std::string_view define) {
+        for (size_t i{}; i < s_variantDefines.size(); i++) {
+            if (s_variantDefines[i] == define) {
+                return static_cast<Variant>(i);
+            }
+        }
+
+        return std::nullopt;
+    }
+}
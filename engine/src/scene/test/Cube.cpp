@@ -5,11 +5,19 @@
 #include <glm/ext/matrix_transform.hpp>
 
 #include "core/Application.h"
+#include "renderer/GlState.h"
 #include "renderer/Renderer.h"
 #include "renderer/VertexArray.h"
 #include "renderer/buffer/Vertex.h"
 #include "renderer/shader/Parser.h"
 
+namespace {
+    using Engine::Renderer::RenderQueue;
+
+    void applyModel(const Engine::Renderer::Shader::Program& program, const RenderQueue::Packet& packet) {
+        program.setUniform("model", packet.transform);
+    }
+}
 
 Engine::Scene::Cube::Cube() : m_shaderProgram{Renderer::Shader::Parser{"../engine/res/shader/test/CubeTest.glsl"}} {
     const Renderer::Buffer::Vertex::Layout cubeLayout{*s_cubePositions.data(), *s_cubeColors.data()};
@@ -44,17 +52,46 @@ void Engine::Scene::Cube::render(const Renderer::Renderer& renderer) {
     m_camera.setPosition(camPos);
     m_camera.lookAt(Math::Vec3::zero);
 
-    m_shaderProgram.bind();
-    m_shaderProgram.setUniform("model", model);
-    m_shaderProgram.setUniform("view", m_camera.getView());
-    m_shaderProgram.setUniform("projection", m_camera.getProjection());
+    renderer.setCamera(m_camera.getBlock());
 
     renderer.clear(glm::vec4{0.f, .5f, 1.f, 1.f});
-    renderer.draw(*m_vertexArray, m_shaderProgram);
+
+    for (int x{}; x < s_gridSize; x++) {
+        for (int y{}; y < s_gridSize; y++) {
+            for (int z{}; z < s_gridSize; z++) {
+                const glm::vec3 cell{static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)};
+                const glm::vec3 position = (cell - static_cast<float>(s_gridSize - 1) * .5f) * 2.f;
+                m_renderQueue.submit(RenderQueue::Packet{
+                    .vertexArray = m_vertexArray.get(),
+                    .program = &m_shaderProgram,
+                    .applyUniforms = applyModel,
+                    .transform = glm::translate(glm::mat4{1.f}, position) * model,
+                    .depth = glm::distance(camPos, position)
+                });
+            }
+        }
+    }
+
+    renderer.draw(m_renderQueue);
 }
 
 void Engine::Scene::Cube::renderImGui() {
     const ImGuiIO& io = ImGui::GetIO();
     ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", static_cast<double>(1000.f / io.Framerate),
                 static_cast<double>(io.Framerate));
+
+    const auto& stats = m_renderQueue.getStats();
+    ImGui::Text("%u packets", stats.packets);
+    ImGui::Text("State changes submitted: %u (%u programs, %u vertex arrays, %u textures)",
+                stats.unsorted.getTotal(), stats.unsorted.programs, stats.unsorted.vertexArrays,
+                stats.unsorted.textures);
+    ImGui::Text("State changes sorted: %u (%u programs, %u vertex arrays, %u textures)", stats.sorted.getTotal(),
+                stats.sorted.programs, stats.sorted.vertexArrays, stats.sorted.textures);
+
+    const auto& uniformStats = m_shaderProgram.getUniformStats();
+    ImGui::Text("Uniforms last frame: %u uploaded, %u skipped", uniformStats.uploads, uniformStats.skipped);
+    m_shaderProgram.resetUniformStats();
+
+    const auto& glStats = Engine::Renderer::GlState::current().getLastFrameStats();
+    ImGui::Text("GL state calls last frame: %u made, %u skipped", glStats.calls, glStats.skipped);
 }
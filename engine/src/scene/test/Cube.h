@@ -5,6 +5,7 @@
 #include "scene/Scene.h"
 #include "renderer/shader/Program.h"
 #include "renderer/Camera.h"
+#include "renderer/RenderQueue.h"
 
 namespace Engine::Renderer {
     class VertexArray;
@@ -69,10 +70,12 @@ namespace Engine::Scene {
             4, 5, 1, 1, 0, 4
         };
 
-        static constexpr float s_camRadius{3.f};
+        static constexpr float s_camRadius{14.f};
+        static constexpr int s_gridSize{5}; // Cubes per side, all drawn through m_renderQueue
 
         Renderer::Camera m_camera;
         Renderer::Shader::Program m_shaderProgram;
         std::unique_ptr<Renderer::VertexArray> m_vertexArray;
+        Renderer::RenderQueue m_renderQueue;
     };
 }
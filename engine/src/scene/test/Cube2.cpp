@@ -9,36 +9,28 @@
 #include "../../renderer/Renderer.h"
 #include "../../renderer/VertexArray.h"
 #include "../../renderer/buffer/Vertex.h"
-#include "../../renderer/shader/Parser.h"
 #include "core/InputMap.h"
+#include "renderer/ResourceCache.h"
+#include "renderer/TextureLoader.h"
 #include "renderer/model/ObjParser.h"
 
-
-std::array<glm::vec3, 64> generateRandomPositions() {
-    std::array<glm::vec3, 64> positions{};
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution dist(-1.0f, 1.0f);
-
-    for (auto& pos: positions) {
-        pos = glm::vec3(dist(gen), dist(gen), dist(gen));
+namespace {
+    // Color then diffuse, specular and emission for every entry. The melon has only a color, also used as diffuse.
+    Engine::Renderer::TextureArray buildMaterials() {
+        Engine::Renderer::TextureArray::Builder builder{glm::ivec2{256}, 4};
+        builder.add({
+            ENGINE_RES_PATH"/texture/Wall.png", ENGINE_RES_PATH"/texture/Wall-diffuse.png",
+            ENGINE_RES_PATH"/texture/Wall-border.png", ENGINE_RES_PATH"/texture/Wall-graffiti.png"
+        });
+        builder.add({ENGINE_RES_PATH"/texture/Melon.png", ENGINE_RES_PATH"/texture/Melon.png", "", ""});
+        return builder.build();
     }
-
-    return positions;
 }
 
-Engine::Scene::Cube2::Cube2() : m_cubeShader{Renderer::Shader::Parser{ENGINE_RES_PATH"/shader/test/CubeTest2.glsl"}},
-                                m_color{
-                                    Renderer::Texture::loadGlTexture(ENGINE_RES_PATH"/texture/Wall.png")
-                                },
-                                m_diffuse{
-                                    Renderer::Texture::loadGlTexture(ENGINE_RES_PATH"/texture/Wall-diffuse.png")
-                                }, m_specular{
-                                    Renderer::Texture::loadGlTexture(ENGINE_RES_PATH"/texture/Wall-border.png")
-                                }, m_emission{
-                                    Renderer::Texture::loadGlTexture(ENGINE_RES_PATH"/texture/Wall-graffiti.png")
-                                } {
+Engine::Scene::Cube2::Cube2() : m_shaders{
+                                    Renderer::ResourceCache::current().getProgramVariants(
+                                        ENGINE_RES_PATH"/shader/source/Base.glsl")
+                                }, m_materials{buildMaterials()} {
     Renderer::ObjParser objParser{ENGINE_RES_PATH"/model/Cube.obj"};
 
     Renderer::Buffer::Vertex::Layout layout{
@@ -54,30 +46,64 @@ Engine::Scene::Cube2::Cube2() : m_cubeShader{Renderer::Shader::Parser{ENGINE_RES
     Renderer::Buffer::Vertex vertexBuffer{layout, interleavedVertexData};
     m_vertexArray = std::make_unique<Renderer::VertexArray>(std::move(vertexBuffer), meshData.indices);
 
-    m_color.bind(0);
-    m_diffuse.bind(1);
-    m_specular.bind(2);
-    m_emission.bind(3);
-    m_cubeShader.bind();
-    m_cubeShader.setUniform("u_texture1", 0);
-    m_cubeShader.setUniform("u_matMap.diffuse", 1);
-    m_cubeShader.setUniform("u_matMap.specular", 2);
-    m_cubeShader.setUniform("u_matMap.emission", 3);
-    m_cubeShader.setUniform("u_matMap.shine", 32.f);
+    // One model matrix per cube spread over four attribute locations, then its texture array region and layer
+    const Renderer::Buffer::Vertex::Layout instanceLayout{
+        Renderer::Buffer::Vertex::Layout::Attribute{Renderer::Shader::DataType::Mat4},
+        Renderer::Buffer::Vertex::Layout::Attribute{Renderer::Shader::DataType::Float4},
+        Renderer::Buffer::Vertex::Layout::Attribute{Renderer::Shader::DataType::Float}
+    };
+    m_vertexArray->setInstanceBuffer(Renderer::Buffer::Stream{instanceLayout, s_cubeCount});
+
+    for (uint32_t slot{}; slot < 4; slot++) {
+        m_sampler.bind(slot);
+    }
+    // No sampler object on this unit, the array's own clamped filtering keeps entries apart
+    m_materials.bind(4);
+
+    using enum Renderer::Shader::Variant;
+    const auto& separateShader = m_shaders->get(
+        Renderer::Shader::toMask(MATERIAL_MAP, POINT_LIGHT, VERTEX_COLOR, INSTANCED));
+    separateShader.bind();
+    separateShader.setUniform("u_texture1", 0);
+    separateShader.setUniform("u_matMap.diffuse", 1);
+    separateShader.setUniform("u_matMap.specular", 2);
+    separateShader.setUniform("u_matMap.emission", 3);
+    separateShader.setUniform("u_matMap.ambient", glm::vec3{1.f});
+    separateShader.setUniform("u_matMap.shine", 32.f);
+
+    const auto& arrayShader = m_shaders->get(
+        Renderer::Shader::toMask(MATERIAL_MAP, POINT_LIGHT, VERTEX_COLOR, INSTANCED, TEXTURE_ARRAY));
+    arrayShader.bind();
+    arrayShader.setUniform("u_textures", 4);
+    arrayShader.setUniform("u_matMap.ambient", glm::vec3{1.f});
+    arrayShader.setUniform("u_matMap.shine", 32.f);
+    selectShader();
 
     // Light default values
-    m_cubeShader.setUniform("u_light.position", glm::vec3{10.0f, 10.0f, 10.0f});
-    m_cubeShader.setUniform("u_light.ambient", glm::vec3{0.2f, 0.2f, 0.2f});
-    m_cubeShader.setUniform("u_light.diffuse", glm::vec3{0.5f, 0.5f, 0.5f});
-    m_cubeShader.setUniform("u_light.specular", glm::vec3{1.0f, 1.0f, 1.0f});
-    m_cubeShader.setUniform("u_light.constant", 1.0f);
-    m_cubeShader.setUniform("u_light.linear", 0.09f);
-    m_cubeShader.setUniform("u_light.quadratic", 0.032f);
+    m_lights.point.position = glm::vec3{10.0f, 10.0f, 10.0f};
+    m_lights.point.ambient = glm::vec3{0.2f, 0.2f, 0.2f};
+    m_lights.point.diffuse = glm::vec3{0.5f, 0.5f, 0.5f};
+    m_lights.point.specular = glm::vec3{1.0f, 1.0f, 1.0f};
+    m_lights.point.constant = 1.0f;
+    m_lights.point.linear = 0.09f;
+    m_lights.point.quadratic = 0.032f;
 
     m_camera.setPosition(glm::vec3{0.f, 0.f, s_camRadius});
     SDL_SetWindowRelativeMouseMode(Application::getInstance().getWindow().getSdlWindow(), true);
 
-    s_cubes = generateRandomPositions();
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution dist(-1.0f, 1.0f);
+
+    m_cubes.resize(s_cubeCount);
+    for (auto& cube: m_cubes) {
+        cube.position = glm::vec3(dist(gen), dist(gen), dist(gen)) * s_cubeSpread;
+        cube.axis = glm::normalize(glm::vec3(dist(gen), dist(gen), dist(gen)));
+        cube.speed = dist(gen) * 2.f;
+    }
+
+    // The first cube stays in the middle, only turned by u_model
+    m_cubes.front() = CubeInstance{glm::vec3{0.f}, glm::vec3{0.f, 1.f, 0.f}, 0.f};
 }
 
 void Engine::Scene::Cube2::update(const double deltaTime) {
@@ -89,30 +115,89 @@ void Engine::Scene::Cube2::render(const Renderer::Renderer& renderer) {
     const auto animSpeed = static_cast<float>(Application::getInstance().getTimeSinceInit());
     model = glm::rotate(model, animSpeed, glm::vec3(0.5f, 1.0f, 0.0f));
 
-    m_cubeShader.setUniform("u_viewPos", m_camera.getPosition());
+    m_lights.point.position = glm::vec3{glm::cos(-animSpeed * 4) * 2.f, .5f, glm::sin(-animSpeed * 4) * 2.f};
+    renderer.setCamera(m_camera.getBlock());
+    renderer.setLights(m_lights);
 
-    const glm::vec3 lightPos{glm::cos(-animSpeed * 4) * 2.f, .5f, glm::sin(-animSpeed * 4) * 2.f};
-    m_cubeShader.setUniform("u_light.position", lightPos);
+    m_cubeShader->bind();
 
-    m_cubeShader.bind();
-
-    m_cubeShader.setUniform("u_model", model);
-    m_cubeShader.setUniform("u_view", m_camera.getView());
-    m_cubeShader.setUniform("u_projection", m_camera.getProjection());
+    m_cubeShader->setUniform(m_modelUniform, model);
     renderer.clear(glm::vec4{1.f, .3f, .2f, 1.f} * .1f);
-    renderer.draw(*m_vertexArray, m_cubeShader);
-
-    for (const auto cubeModel: s_cubes) {
-        model = glm::mat4{1.f};
-        model = glm::translate(model, cubeModel * 16.f);
-        model = glm::rotate(model, animSpeed, glm::vec3(0.5f, 1.0f, 0.0f));
-        m_cubeShader.setUniform("u_model", model);
-        renderer.draw(*m_vertexArray, m_cubeShader);
+
+    // Written straight into the instance buffer, every cube spins on its own axis on top of u_model
+    const auto instances = m_vertexArray->mapInstances(s_cubeCount);
+    auto* data = reinterpret_cast<InstanceData*>(instances.data());
+    for (size_t i{}; i < m_cubes.size(); i++) {
+        const auto& cube = m_cubes[i];
+        const auto& region = m_materials.getRegion(static_cast<uint32_t>(i % m_materials.getEntryCount()));
+        data[i] = InstanceData{
+            glm::rotate(glm::translate(glm::mat4{1.f}, cube.position), animSpeed * cube.speed, cube.axis),
+            region.getUvTransform(), static_cast<float>(region.layer)
+        };
     }
+    m_vertexArray->commitInstances();
+
+    renderer.drawInstanced(*m_vertexArray, *m_cubeShader, s_cubeCount);
 }
 
 void Engine::Scene::Cube2::renderImGui() {
     const ImGuiIO& io = ImGui::GetIO();
     ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", static_cast<double>(1000.f / io.Framerate),
                 static_cast<double>(io.Framerate));
+    ImGui::Text("%u cubes in one instanced draw", s_cubeCount);
+    if (ImGui::Checkbox("Texture array", &m_useTextureArray)) {
+        selectShader();
+    }
+    if (m_useTextureArray) {
+        ImGui::Text("%u materials in %u layers, %.1f%% of the layers used", m_materials.getEntryCount(),
+                    m_materials.getLayerCount(), static_cast<double>(m_materials.getOccupancy() * 100.f));
+    } else {
+        ImGui::Text("Separate textures, every cube uses the wall");
+    }
+
+    const auto& uniformStats = m_cubeShader->getUniformStats();
+    ImGui::Text("Uniforms last frame: %u uploaded, %u skipped", uniformStats.uploads, uniformStats.skipped);
+    m_cubeShader->resetUniformStats();
+
+    const auto& textureStats = Renderer::TextureLoader::current().getStats();
+    ImGui::Text("Textures streaming: %u, uploaded last frame: %u (%zu KiB)", textureStats.inFlight,
+                textureStats.uploaded, textureStats.uploadedBytes / 1024);
+
+    using Renderer::ResourceCache;
+    const auto& resourceCache = ResourceCache::current();
+    for (size_t type{}; type < static_cast<size_t>(ResourceCache::Type::COUNT); type++) {
+        const auto& stats = resourceCache.getStats(static_cast<ResourceCache::Type>(type));
+        ImGui::Text("%s: %u resident, %u in use (%zu KiB), %u hits, %u misses",
+                    ResourceCache::toString(static_cast<ResourceCache::Type>(type)), stats.resident, stats.referenced,
+                    stats.bytes / 1024, stats.hits, stats.misses);
+    }
+}
+
+void Engine::Scene::Cube2::selectShader() {
+    using enum Renderer::Shader::Variant;
+    auto mask = Renderer::Shader::toMask(MATERIAL_MAP, POINT_LIGHT, VERTEX_COLOR, INSTANCED);
+    if (m_useTextureArray) {
+        mask |= Renderer::Shader::toMask(TEXTURE_ARRAY);
+    } else {
+        loadSeparateMaps();
+    }
+
+    m_cubeShader = &m_shaders->get(mask);
+    m_modelUniform = m_cubeShader->getUniformSlot("u_model");
+}
+
+void Engine::Scene::Cube2::loadSeparateMaps() {
+    if (!m_separateMaps.empty()) {
+        return;
+    }
+
+    // Not until first shown, the array already decoded the same images
+    auto& resourceCache = Renderer::ResourceCache::current();
+    m_separateMaps.push_back(resourceCache.getTexture(ENGINE_RES_PATH"/texture/Wall.png"));
+    m_separateMaps.push_back(resourceCache.getTexture(ENGINE_RES_PATH"/texture/Wall-diffuse.png", true));
+    m_separateMaps.push_back(resourceCache.getTexture(ENGINE_RES_PATH"/texture/Wall-border.png", true));
+    m_separateMaps.push_back(resourceCache.getTexture(ENGINE_RES_PATH"/texture/Wall-graffiti.png", true));
+    for (uint32_t slot{}; slot < m_separateMaps.size(); slot++) {
+        m_separateMaps[slot].bind(slot);
+    }
 }
@@ -1,12 +1,16 @@
 #pragma once
 #include <array>
+#include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 
 #include "core/InputMap.h"
 #include "scene/Scene.h"
 #include "renderer/shader/Program.h"
+#include "renderer/shader/ProgramVariants.h"
 #include "renderer/Camera.h"
+#include "renderer/Sampler.h"
 #include "renderer/Texture.h"
+#include "renderer/TextureArray.h"
 #include "renderer/model/Model.h"
 
 namespace Engine::Renderer {
@@ -167,18 +171,42 @@ namespace Engine::Scene {
             }
         };*/
 
-        static inline std::array<glm::vec3, 64> s_cubes;
+        struct CubeInstance {
+            glm::vec3 position;
+            glm::vec3 axis;
+            float speed;
+        };
+
+        // What each cube gets in the instance buffer, region and layer are only read by the texture array variant
+        struct InstanceData {
+            glm::mat4 transform;
+            glm::vec4 region;
+            float layer;
+        };
+
+        static_assert(sizeof(InstanceData) == 84, "Must match the instance layout");
+
+        void selectShader();
+
+        void loadSeparateMaps();
+
+        static constexpr uint32_t s_cubeCount{10'000};
+        static constexpr float s_cubeSpread{48.f};
 
         static constexpr float s_camRadius{3.f};
 
         Renderer::Camera m_camera;
-        Renderer::Shader::Program m_cubeShader;
-        Renderer::Texture m_color;
-        Renderer::Texture m_diffuse;
-        Renderer::Texture m_specular;
-        Renderer::Texture m_emission;
+        std::shared_ptr<Renderer::Shader::ProgramVariants> m_shaders;
+        const Renderer::Shader::Program* m_cubeShader{};
+        Renderer::Shader::Program::UniformSlot m_modelUniform;
+        std::vector<Renderer::Texture> m_separateMaps; // Color, diffuse, specular and emission of the wall
+        Renderer::Sampler m_sampler{{.anisotropy = 8.f}}; // Shared by all four material maps
+        Renderer::TextureArray m_materials; // Wall and melon, every cube alternating between them
+        bool m_useTextureArray{true};
         std::unique_ptr<Renderer::VertexArray> m_vertexArray;
         std::optional<Renderer::Model> m_model;
         glm::vec3 m_lightColor{1.f, 1.f, 1.f};
+        Renderer::Shader::LightBlock m_lights;
+        std::vector<CubeInstance> m_cubes;
     };
 }
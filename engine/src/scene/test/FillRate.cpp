@@ -0,0 +1,94 @@
+#include "FillRate.h"
+
+#include <imgui.h>
+#include <glad/glad.h>
+
+#include "core/Application.h"
+#include "renderer/GlState.h"
+#include "renderer/Renderer.h"
+#include "renderer/ResourceCache.h"
+#include "renderer/shader/Parser.h"
+
+Engine::Scene::FillRate::FillRate() : m_shader{Renderer::Shader::Parser{ENGINE_RES_PATH"/shader/test/FillRate.glsl"}},
+                                      m_texture{
+                                          Renderer::ResourceCache::current().getTexture(
+                                              ENGINE_RES_PATH"/texture/Wall.png", false, false)
+                                      },
+                                      m_modes{
+                                          Mode{"Nearest", Renderer::Sampler{{.filter = Filter::NEAREST}}},
+                                          Mode{"Trilinear", Renderer::Sampler{}},
+                                          Mode{"Trilinear 16x aniso", Renderer::Sampler{{.anisotropy = 16.f}}}
+                                      } {
+    const Renderer::Buffer::Vertex::Layout layout{
+        glm::vec2{},
+        glm::vec2{}
+    };
+    Renderer::Buffer::Vertex vertexBuffer{layout, s_quad.data(), sizeof(s_quad)};
+    m_vertexArray = std::make_unique<Renderer::VertexArray>(std::move(vertexBuffer), s_indices);
+
+    for (auto& mode: m_modes) {
+        RENDERER_API_CALL(glGenQueries(static_cast<GLsizei>(mode.queries.size()), mode.queries.data()));
+    }
+
+    m_texture.bind(0);
+    m_shader.setUniform("u_texture", 0);
+}
+
+Engine::Scene::FillRate::~FillRate() {
+    for (auto& mode: m_modes) {
+        RENDERER_API_CALL(glDeleteQueries(static_cast<GLsizei>(mode.queries.size()), mode.queries.data()));
+    }
+
+    Renderer::Sampler::unbind(0);
+}
+
+void Engine::Scene::FillRate::readQuery(const Renderer::Id query, double& gpuMs) {
+    GLint available{};
+    RENDERER_API_CALL(glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available));
+    if (available == 0) {
+        return;
+    }
+
+    GLuint64 elapsed{};
+    RENDERER_API_CALL(glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed));
+    gpuMs = static_cast<double>(elapsed) / 1'000'000.0;
+}
+
+void Engine::Scene::FillRate::render(const Renderer::Renderer& renderer) {
+    renderer.clear(glm::vec4{0.f});
+
+    // Every layer has to be shaded, the depth test would reject all but the first
+    auto& state = Renderer::GlState::current();
+    state.setDepthTest(false);
+
+    const auto queryIndex = static_cast<uint32_t>(m_frame % s_queryFrames);
+    for (auto& mode: m_modes) {
+        const Renderer::Id query = mode.queries[queryIndex];
+        if (m_frame >= s_queryFrames) {
+            readQuery(query, mode.gpuMs);
+        }
+
+        mode.sampler.bind(0);
+        RENDERER_API_CALL(glBeginQuery(GL_TIME_ELAPSED, query));
+        for (uint32_t layer{}; layer < s_overdraw; layer++) {
+            renderer.draw(*m_vertexArray, m_shader);
+        }
+        RENDERER_API_CALL(glEndQuery(GL_TIME_ELAPSED));
+    }
+
+    state.setDepthTest(true);
+    m_frame++;
+}
+
+void Engine::Scene::FillRate::renderImGui() {
+    const ImGuiIO& io = ImGui::GetIO();
+    ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", static_cast<double>(1000.f / io.Framerate),
+                static_cast<double>(io.Framerate));
+
+    const glm::ivec2 size = Application::getInstance().getWindow().getSize();
+    const double pixels = static_cast<double>(size.x) * size.y * s_overdraw;
+    for (const auto& mode: m_modes) {
+        const double gpixelsPerSecond = mode.gpuMs > 0.0 ? pixels / (mode.gpuMs * 1'000'000.0) : 0.0;
+        ImGui::Text("%-20s %7.3f ms GPU, %6.2f Gpixels/s", mode.name, mode.gpuMs, gpixelsPerSecond);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <glm/vec2.hpp>
+
+#include "core/Typedef.h"
+#include "scene/Scene.h"
+#include "renderer/Sampler.h"
+#include "renderer/Texture.h"
+#include "renderer/VertexArray.h"
+#include "renderer/shader/Program.h"
+
+namespace Engine::Scene {
+    // Microbenchmark for texture filtering. Covers the screen with a heavily tiled texture many times over and times
+    // each sampler on the GPU, minified texels without mips miss the texture cache far more often.
+    class FillRate final : public Scene {
+    public:
+        FillRate();
+
+        FillRate(const FillRate&) = delete;
+
+        FillRate& operator=(const FillRate&) = delete;
+
+        FillRate(FillRate&&) = delete;
+
+        FillRate& operator=(FillRate&&) = delete;
+
+        ~FillRate() override;
+
+        void render(const Renderer::Renderer& renderer) override;
+
+        void renderImGui() override;
+
+    private:
+        // Frames a query result may lag behind, reading it any sooner would stall on the GPU
+        static constexpr uint32_t s_queryFrames{3};
+        static constexpr uint32_t s_overdraw{16};
+        static constexpr float s_tiling{64.f};
+
+        static constexpr std::array<glm::vec2, 8> s_quad{
+            {
+                {-1.f, -1.f}, {0.f, 0.f},
+                {1.f, -1.f}, {s_tiling, 0.f},
+                {1.f, 1.f}, {s_tiling, s_tiling},
+                {-1.f, 1.f}, {0.f, s_tiling}
+            }
+        };
+
+        static constexpr std::array<uint32_t, 6> s_indices{
+            0, 1, 2,
+            2, 3, 0
+        };
+
+        using Filter = Renderer::Sampler::Filter;
+
+        struct Mode {
+            const char* name{};
+            Renderer::Sampler sampler;
+            std::array<Renderer::Id, s_queryFrames> queries{};
+            double gpuMs{}; // Of the latest result
+        };
+
+        // Reads the result the query got s_queryFrames ago, if the GPU is done with it
+        static void readQuery(Renderer::Id query, double& gpuMs);
+
+        std::unique_ptr<Renderer::VertexArray> m_vertexArray;
+        Renderer::Shader::Program m_shader;
+        Renderer::Texture m_texture;
+        std::array<Mode, 3> m_modes;
+        uint64_t m_frame{};
+    };
+}
@@ -1,31 +1,40 @@
 #include "ModelTest.h"
 
+#include <algorithm>
 #include <imgui.h>
 
 #include "core/Application.h"
-#include "renderer/model/ObjParser.h"
+#include "renderer/ResourceCache.h"
+#include "renderer/model/MeshCache.h"
+
+namespace {
+    void setMaterial(const Engine::Renderer::Shader::Program& shader) {
+        shader.setUniform("u_texture1", 0);
+        shader.setUniform("u_material.diffuse", glm::vec3{.8f});
+        shader.setUniform("u_material.specular", glm::vec3{.9f});
+        shader.setUniform("u_material.emission", glm::vec3{.0f});
+        shader.setUniform("u_material.shine", 32.f);
+    }
+}
 
 Engine::ModelTest::ModelTest() : m_shader{
     ENGINE_RES_PATH"/shader/source/Base.vert", ENGINE_RES_PATH"/shader/source/Base.frag"
-} {
-    Renderer::ObjParser parser{ENGINE_RES_PATH"/model/Eye.obj"};
-
-    m_model = Renderer::Model::generate(parser.next(), {
-                                            Renderer::Texture::loadGlTexture(ENGINE_RES_PATH"/texture/Wall.png")
-                                        });
-
-    m_model->getTextures().front().bind(0);
-    m_shader.bind();
-    m_shader.setUniform("u_texture1", 0);
-    m_shader.setUniform("u_material.diffuse", glm::vec3{.8f});
-    m_shader.setUniform("u_material.specular", glm::vec3{.9f});
-    m_shader.setUniform("u_material.emission", glm::vec3{.0f});
-    m_shader.setUniform("u_material.shine", 32.f);
-
-    m_shader.setUniform("u_light.ambient", glm::vec3{0.4f, 0.4f, 0.4f});
-    m_shader.setUniform("u_light.diffuse", glm::vec3{0.5f, 0.5f, 0.5f});
-    m_shader.setUniform("u_light.specular", glm::vec3{1.0f, 1.0f, 1.0f});
-    m_shader.setUniform("u_light.direction", normalize(glm::vec3{-1.f, -1.f, -1.f}));
+}, m_quantizedShader{
+    ENGINE_RES_PATH"/shader/source/Compressed.vert", ENGINE_RES_PATH"/shader/source/Base.frag"
+}, m_fallback{ENGINE_RES_PATH"/shader/source/Base.vert", ENGINE_RES_PATH"/shader/source/Fallback.frag"},
+  m_texture{Renderer::ResourceCache::current().getTexture(ENGINE_RES_PATH"/texture/Wall.png", false, false)} {
+    m_model = Renderer::ResourceCache::current().getModel(ENGINE_RES_PATH"/model/Eye.obj");
+    const auto cookedMesh = Renderer::MeshCache::loadOrCook(ENGINE_RES_PATH"/model/Eye.obj");
+    m_quantizedModel = Renderer::Model::generateCompressed(cookedMesh);
+    m_vertexCount = cookedMesh.getVertexCount();
+
+    m_texture.bind(0);
+    m_sampler.bind(0);
+
+    m_lights.directional.ambient = glm::vec3{0.4f, 0.4f, 0.4f};
+    m_lights.directional.diffuse = glm::vec3{0.5f, 0.5f, 0.5f};
+    m_lights.directional.specular = glm::vec3{1.0f, 1.0f, 1.0f};
+    m_lights.directional.direction = normalize(glm::vec3{-1.f, -1.f, -1.f});
 
     m_instancePositions.resize(100);
     for (size_t i{}; i < m_instancePositions.size(); i++) {
@@ -33,11 +42,12 @@ Engine::ModelTest::ModelTest() : m_shader{
     }
 
     const Renderer::Buffer::Vertex::Layout instanceLayout{*m_instancePositions.data()};
-    Renderer::Buffer::Vertex instanceBuffer{
-        instanceLayout, m_instancePositions.data(),
-        static_cast<uint32_t>(m_instancePositions.size() * instanceLayout.getStride())
-    };
-    m_model->setInstanceBuffer(std::move(instanceBuffer));
+    m_model->setInstanceBuffer(Renderer::Buffer::Stream{
+        instanceLayout, static_cast<uint32_t>(m_instancePositions.size())
+    });
+    m_quantizedModel->setInstanceBuffer(Renderer::Buffer::Stream{
+        instanceLayout, static_cast<uint32_t>(m_instancePositions.size())
+    });
 }
 
 void Engine::ModelTest::update(const double deltaTime) {
@@ -49,19 +59,72 @@ void Engine::ModelTest::render(const Renderer::Renderer& renderer) {
     const auto animSpeed = static_cast<float>(Application::getInstance().getTimeSinceInit());
     model = glm::rotate(model, animSpeed, glm::vec3(0.5f, 1.0f, 0.0f));
 
-    m_shader.setUniform("u_viewPos", m_camera.getPosition());
+    renderer.setCamera(m_camera.getBlock());
+    renderer.setLights(m_lights);
 
-    m_shader.bind();
+    const auto* shader = &m_shader.getOr(m_fallback);
+    if (!m_materialSet && m_shader.isValid()) {
+        setMaterial(*shader);
+        m_materialSet = true;
+    }
+
+    // The full precision model stands in until Compressed.vert is built
+    auto* drawnModel = m_model.get();
+    if (m_quantized) {
+        const auto& quantizedShader = m_quantizedShader.getOr(m_fallback);
+        if (m_quantizedShader.isValid()) {
+            if (!m_quantizedMaterialSet) {
+                quantizedShader.bind();
+                setMaterial(quantizedShader);
+                m_quantizedModel->applyDequantization(quantizedShader);
+                m_quantizedMaterialSet = true;
+            }
 
-    m_shader.setUniform("u_model", model);
-    m_shader.setUniform("u_view", m_camera.getView());
-    m_shader.setUniform("u_projection", m_camera.getProjection());
+            shader = &quantizedShader;
+            drawnModel = &*m_quantizedModel;
+        }
+    }
+
+    shader->bind();
+    shader->setUniform("u_model", model);
     renderer.clear(glm::vec4{1.f, .3f, .2f, 1.f} * .1f);
-    m_model->drawInstanced(m_shader, m_instancePositions.data(), static_cast<uint32_t>(m_instancePositions.size()));
+
+    const auto& bounds = drawnModel->getBounds();
+    m_instanceLods.resize(m_instancePositions.size());
+    for (size_t i{}; i < m_instancePositions.size(); i++) {
+        const float screenSize = m_camera.projectedSize(m_instancePositions[i] + bounds.center, bounds.radius);
+        m_instanceLods[i] = drawnModel->selectLod(screenSize);
+    }
+
+    drawnModel->drawInstancedLod(*shader, m_instancePositions.data(), m_instanceLods);
 }
 
 void Engine::ModelTest::renderImGui() {
     const ImGuiIO& io = ImGui::GetIO();
     ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", static_cast<double>(1000.f / io.Framerate),
                 static_cast<double>(io.Framerate));
+
+    if (!m_shader.isReady()) {
+        ImGui::Text("Shader still compiling, drawing the fallback");
+    }
+
+    const auto& shader = m_shader.getOr(m_fallback);
+    const auto& uniformStats = shader.getUniformStats();
+    ImGui::Text("Uniforms last frame: %u uploaded, %u skipped", uniformStats.uploads, uniformStats.skipped);
+    shader.resetUniformStats();
+
+    ImGui::Checkbox("Quantized vertices", &m_quantized);
+    const size_t fullStride = Renderer::MeshData::baseLayout().getStride();
+    const size_t quantizedStride = Renderer::VertexCompression::layout().getStride();
+    const size_t stride = m_quantized ? quantizedStride : fullStride;
+    ImGui::Text("%zu bytes per vertex, %zu quantized instead of %zu (-%.0f%%), %zu KiB for %u vertices", stride,
+                quantizedStride, fullStride,
+                static_cast<double>(100.f - static_cast<float>(quantizedStride * 100) / static_cast<float>(fullStride)),
+                stride * m_vertexCount / 1024, m_vertexCount);
+
+    const auto& lods = m_model->getLods();
+    for (size_t lod{}; lod < lods.size(); lod++) {
+        ImGui::Text("Lod %zu: %u triangles, %td instances", lod, lods[lod].indexCount / 3,
+                    std::ranges::count(m_instanceLods, static_cast<uint8_t>(lod)));
+    }
 }
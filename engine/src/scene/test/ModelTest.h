@@ -1,7 +1,9 @@
 #pragma once
 #include "renderer/Camera.h"
+#include "renderer/Sampler.h"
 #include "renderer/model/Model.h"
 #include "renderer/shader/Program.h"
+#include "renderer/shader/ProgramFuture.h"
 #include "scene/Scene.h"
 
 namespace Engine {
@@ -19,8 +21,21 @@ namespace Engine {
 
     private:
         Renderer::Camera m_camera;
-        std::optional<Renderer::Model> m_model;
+        std::shared_ptr<Renderer::Model> m_model;
+        std::optional<Renderer::Model> m_quantizedModel; // Same mesh in the VertexCompression format
+        uint32_t m_vertexCount{};
         std::vector<glm::vec3> m_instancePositions;
-        Renderer::Shader::Program m_shader;
+        std::vector<uint8_t> m_instanceLods;
+        // Started first so the driver works on it while the fallback builds
+        Renderer::Shader::ProgramFuture m_shader;
+        Renderer::Shader::ProgramFuture m_quantizedShader;
+        Renderer::Shader::Program m_fallback;
+        Renderer::Texture m_texture;
+        // The eyes are mostly seen at grazing angles from afar
+        Renderer::Sampler m_sampler{{.filter = Renderer::Sampler::Filter::TRILINEAR, .anisotropy = 16.f}};
+        bool m_materialSet{};
+        bool m_quantizedMaterialSet{};
+        bool m_quantized{};
+        Renderer::Shader::LightBlock m_lights;
     };
 }
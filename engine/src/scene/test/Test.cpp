@@ -1,13 +1,15 @@
 #include "Test.h"
 
 #include "core/Application.h"
+#include "renderer/ResourceCache.h"
 #include "renderer/shader/Parser.h"
 #include <imgui.h>
 #include <memory>
 
 Engine::Scene::Test::Test() : m_shaderProgram{Renderer::Shader::Parser{"../engine/res/shader/test/Basic.glsl"}},
                               m_texture{
-                                  Renderer::Texture::loadGlTexture("../engine/res/texture/Melon.png")
+                                  Renderer::ResourceCache::current().getTexture("../engine/res/texture/Melon.png", false,
+                                                                                false)
                               } {
     const Renderer::Buffer::Vertex::Layout vertexLayout{
         glm::vec2{},